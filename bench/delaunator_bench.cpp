@@ -0,0 +1,527 @@
+// delaunator_bench: times delaunator::Delaunator on the point distributions the
+// wallpaper produces (and a few adversarial ones) and prints the results as JSON.
+//
+// usage: delaunator_bench [--max-points N] [--threads N] [--frames N] [--seed N]
+//        delaunator_bench --trace FILE [--threads N]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <delaunator/delaunator.hpp>
+#include <nlohmann/json.hpp>
+#include <input_trace.hpp>
+#include <star.hpp>
+#include <star_system.hpp>
+#include <types.hpp>
+
+// ============================================================
+// Allocation tracking
+// ============================================================
+// Every allocation carries a small header with its size so the live byte count
+// (and its peak) can be kept without help from the allocator.
+
+namespace {
+
+constexpr std::size_t kAllocHeader = alignof(std::max_align_t);
+
+std::atomic<std::size_t> gAllocations{ 0 };
+std::atomic<std::size_t> gLiveBytes{ 0 };
+std::atomic<std::size_t> gPeakBytes{ 0 };
+
+void* trackedAlloc(std::size_t size) {
+    void* block = std::malloc(size + kAllocHeader);
+    if (!block) throw std::bad_alloc();
+    *static_cast<std::size_t*>(block) = size;
+
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t live = gLiveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    std::size_t peak = gPeakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !gPeakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+
+    return static_cast<char*>(block) + kAllocHeader;
+}
+
+void trackedFree(void* ptr) noexcept {
+    if (!ptr) return;
+    void* block = static_cast<char*>(ptr) - kAllocHeader;
+    gLiveBytes.fetch_sub(*static_cast<std::size_t*>(block), std::memory_order_relaxed);
+    std::free(block);
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return trackedAlloc(size); }
+void* operator new[](std::size_t size) { return trackedAlloc(size); }
+void operator delete(void* ptr) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { trackedFree(ptr); }
+
+namespace {
+
+using namespace delaunay_flow;
+using Clock = std::chrono::steady_clock;
+
+struct AllocScope {
+    std::size_t allocations;
+    std::size_t liveBytes;
+
+    AllocScope()
+        : allocations(gAllocations.load()),
+          liveBytes(gLiveBytes.load()) {
+        gPeakBytes.store(liveBytes);
+    }
+
+    [[nodiscard]] std::size_t count() const { return gAllocations.load() - allocations; }
+    [[nodiscard]] std::size_t peak() const { return gPeakBytes.load() - liveBytes; }
+};
+
+struct Options {
+    std::size_t maxPoints = 1'000'000;
+    std::size_t threads   = 1;
+    int         frames    = 600;
+    unsigned    seed      = 1;
+    std::string trace;
+};
+
+// ============================================================
+// Point distributions
+// ============================================================
+// All distributions fill roughly the same area as the wallpaper's star field:
+// [-1.3, 1.3]^2 scaled by a 16:9 aspect ratio on x.
+
+constexpr float kAspect = 16.0f / 9.0f;
+constexpr float kExtent = 1.3f;
+
+std::vector<float> uniformPoints(std::size_t n, std::mt19937& gen) {
+    std::uniform_real_distribution<float> x(-kExtent * kAspect, kExtent * kAspect);
+    std::uniform_real_distribution<float> y(-kExtent, kExtent);
+
+    std::vector<float> coords(2 * n);
+    for (std::size_t i = 0; i < n; ++i) {
+        coords[2 * i]     = x(gen);
+        coords[2 * i + 1] = y(gen);
+    }
+    return coords;
+}
+
+// a few dense gaussian blobs plus a sparse uniform background
+std::vector<float> clusteredPoints(std::size_t n, std::mt19937& gen) {
+    constexpr int   kClusters   = 12;
+    constexpr float kBackground = 0.1f;
+
+    std::vector<float> coords = uniformPoints(n, gen);
+
+    std::vector<float> centers = uniformPoints(kClusters, gen);
+    std::uniform_int_distribution<int>    cluster(0, kClusters - 1);
+    std::uniform_real_distribution<float> pick(0.0f, 1.0f);
+    std::normal_distribution<float>       spread(0.0f, 0.05f);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        if (pick(gen) < kBackground) continue;
+        const int c = cluster(gen);
+        coords[2 * i]     = centers[2 * c] + spread(gen);
+        coords[2 * i + 1] = centers[2 * c + 1] + spread(gen);
+    }
+    return coords;
+}
+
+// a square lattice: every cell is four cocircular points
+std::vector<float> gridPoints(std::size_t n, std::mt19937& gen) {
+    const std::size_t side = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(n))));
+    const float step = 2.0f * kExtent / static_cast<float>(side);
+
+    std::vector<float> coords;
+    coords.reserve(2 * n);
+    for (std::size_t i = 0; i < n; ++i) {
+        coords.push_back(-kExtent + step * static_cast<float>(i % side));
+        coords.push_back(-kExtent + step * static_cast<float>(i / side));
+    }
+
+    // shuffle the input order so the lattice is not also pre-sorted
+    std::vector<std::size_t> order(n);
+    for (std::size_t i = 0; i < n; ++i) order[i] = i;
+    std::shuffle(order.begin(), order.end(), gen);
+
+    std::vector<float> shuffled(2 * n);
+    for (std::size_t i = 0; i < n; ++i) {
+        shuffled[2 * i]     = coords[2 * order[i]];
+        shuffled[2 * i + 1] = coords[2 * order[i] + 1];
+    }
+    return shuffled;
+}
+
+// points scattered a hair's width around a slanted line
+std::vector<float> nearCollinearPoints(std::size_t n, std::mt19937& gen) {
+    std::uniform_real_distribution<float> t(-kExtent * kAspect, kExtent * kAspect);
+    std::uniform_real_distribution<float> jitter(-1e-3f, 1e-3f);
+
+    std::vector<float> coords(2 * n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const float x = t(gen);
+        coords[2 * i]     = x;
+        coords[2 * i + 1] = 0.3f * x + jitter(gen);
+    }
+    return coords;
+}
+
+// the wallpaper's own workload: stars with default speeds after `frames` frames at 120 fps
+Stars makeStars(std::size_t n, std::mt19937& gen, const Rect& bounds) {
+    std::uniform_real_distribution<float> x(bounds.left, bounds.right);
+    std::uniform_real_distribution<float> y(bounds.bottom, bounds.top);
+    std::uniform_real_distribution<float> speed(0.005f, 0.026f);
+    std::uniform_real_distribution<float> angle(0.0f, TAU_F);
+
+    Stars stars;
+    stars.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const float sx = x(gen);
+        const float sy = y(gen);
+        const float sv = speed(gen);
+        stars.add(sx, sy, sv, angle(gen));
+    }
+    return stars;
+}
+
+void starCoords(const Stars& stars, std::vector<float>& coords) {
+    coords.resize(2 * stars.size());
+    for (std::size_t i = 0; i < stars.size(); ++i) {
+        coords[2 * i]     = stars.x[i];
+        coords[2 * i + 1] = stars.y[i];
+    }
+}
+
+constexpr float kFrameDt = 1.0f / 120.0f;
+
+const Rect kStarBounds(-kExtent * kAspect, kExtent * kAspect, -kExtent, kExtent);
+
+const StarMotion kStarMotion{ kFrameDt, kStarBounds };
+
+Stars settledStars(std::size_t n, std::mt19937& gen, int frames) {
+    Stars stars = makeStars(n, gen, kStarBounds);
+    for (int f = 0; f < frames; ++f) {
+        moveStars(stars, kStarMotion, 0, stars.size());
+    }
+    return stars;
+}
+
+std::vector<float> starPoints(std::size_t n, std::mt19937& gen, int frames) {
+    std::vector<float> coords;
+    starCoords(settledStars(n, gen, frames), coords);
+    return coords;
+}
+
+// ============================================================
+// Measurements
+// ============================================================
+
+[[nodiscard]] double nsPerPoint(Clock::duration elapsed, std::size_t points) {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+           static_cast<double>(points);
+}
+
+[[nodiscard]] double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+template <typename D, typename Scalar>
+nlohmann::json measure(const std::vector<Scalar>& coords, const Options& options) {
+    const std::size_t n = coords.size() / 2;
+    nlohmann::json result;
+
+    // cold: a fresh Delaunator, as the first frame or a point count change would see it
+    {
+        AllocScope scope;
+        const auto start = Clock::now();
+        D d;
+        d.update(coords, options.threads);
+        const auto elapsed = Clock::now() - start;
+        const std::size_t allocations = scope.count();
+        const std::size_t peakBytes   = scope.peak();
+
+        result["cold"] = {
+            { "ns_per_point", nsPerPoint(elapsed, n) },
+            { "allocations", allocations },
+            { "peak_bytes", peakBytes },
+            { "triangles", d.triangles.size() / 3 }
+        };
+    }
+
+    // warm: repeated update() on one Delaunator, as the render loop does it
+    {
+        D d;
+        d.update(coords, options.threads);
+
+        const std::size_t reps = std::clamp<std::size_t>(2'000'000 / n, 3, 200);
+        std::vector<double> samples;
+        samples.reserve(reps);
+
+        AllocScope scope;
+        for (std::size_t r = 0; r < reps; ++r) {
+            const auto start = Clock::now();
+            d.update(coords, options.threads);
+            samples.push_back(nsPerPoint(Clock::now() - start, n));
+        }
+        const std::size_t allocations = scope.count();
+        const std::size_t peakBytes   = scope.peak();
+
+        result["update"] = {
+            { "ns_per_point", median(samples) },
+            { "ns_per_point_min", *std::min_element(samples.begin(), samples.end()) },
+            { "reps", reps },
+            { "allocations", allocations },
+            { "peak_bytes", peakBytes }
+        };
+    }
+    return result;
+}
+
+// kinetic: consecutive frames of moving stars, fixed up with repair()
+template <typename D, typename Scalar>
+nlohmann::json measureMotion(std::size_t n, std::mt19937& gen, const Options& options) {
+    constexpr int kMotionFrames = 60;
+
+    Stars stars = settledStars(n, gen, options.frames);
+
+    std::vector<float> positions;
+    starCoords(stars, positions);
+    std::vector<Scalar> coords(positions.begin(), positions.end());
+
+    D d;
+    d.update(coords, options.threads);
+
+    std::vector<double> samples;
+    samples.reserve(kMotionFrames);
+    std::size_t repaired = 0;
+
+    AllocScope scope;
+    for (int f = 0; f < kMotionFrames; ++f) {
+        moveStars(stars, kStarMotion, 0, stars.size());
+        starCoords(stars, positions);
+        std::copy(positions.begin(), positions.end(), coords.begin());
+
+        const auto start = Clock::now();
+        if (d.repair(coords, options.threads)) ++repaired;
+        samples.push_back(nsPerPoint(Clock::now() - start, n));
+    }
+    const std::size_t allocations = scope.count();
+    const std::size_t peakBytes   = scope.peak();
+
+    return {
+        { "ns_per_point", median(samples) },
+        { "frames", kMotionFrames },
+        { "repaired_frames", repaired },
+        { "repaired_ratio", static_cast<double>(repaired) / kMotionFrames },
+        { "allocations", allocations },
+        { "peak_bytes", peakBytes }
+    };
+}
+
+// ============================================================
+// Trace replay
+// ============================================================
+// Plays a trace recorded by the wallpaper ("simulation.trace") back through the
+// StarSystem and kinetic Delaunator32 it drives, frame by frame, so two builds can
+// be timed on identical star trajectories; equal checksums mean equal meshes.
+
+[[nodiscard]] double milliseconds(Clock::duration elapsed) {
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+nlohmann::json replayTrace(const Options& options) {
+    TraceReader reader(options.trace);
+    const TraceHeader& header = reader.header();
+
+    StarSystem starSystem(starSystemParams(header, options.threads), header.bounds);
+    delaunator::Delaunator32 d;
+
+    std::vector<double> simulateMs;
+    std::vector<double> triangulateMs;
+    std::size_t   repaired = 0;
+    std::uint64_t checksum = 14695981039346656037ULL;   // FNV-1a over every frame's triangles
+
+    TraceFrame frame;
+    while (reader.next(frame)) {
+        if (frame.reset) {
+            starSystem.reset();
+        }
+
+        const auto start = Clock::now();
+        starSystem.advance(std::chrono::duration<float>(frame.frameTime), frame.sources);
+        const auto simulated = Clock::now();
+        if (d.repair(starSystem.positions(), options.threads)) ++repaired;
+        const auto triangulated = Clock::now();
+        starSystem.setNeighbors(d.triangles, d.halfedges);
+
+        simulateMs.push_back(milliseconds(simulated - start));
+        triangulateMs.push_back(milliseconds(triangulated - simulated));
+
+        for (const std::uint32_t index : d.triangles) {
+            checksum = (checksum ^ index) * 1099511628211ULL;
+        }
+    }
+
+    if (simulateMs.empty()) {
+        return { { "trace", options.trace }, { "error", "the trace has no frames" } };
+    }
+
+    return {
+        { "benchmark", "trace" },
+        { "trace", options.trace },
+        { "threads", options.threads },
+        { "seed", header.seed },
+        { "stars", header.count },
+        { "frames", simulateMs.size() },
+        { "repaired_frames", repaired },
+        { "triangles_checksum", checksum },
+        { "simulate_ms", { { "median", median(simulateMs) },
+                           { "max", *std::max_element(simulateMs.begin(), simulateMs.end()) } } },
+        { "triangulate_ms", { { "median", median(triangulateMs) },
+                              { "max", *std::max_element(triangulateMs.begin(), triangulateMs.end()) } } },
+        { "per_frame", { { "simulate_ms", simulateMs }, { "triangulate_ms", triangulateMs } } }
+    };
+}
+
+using Generator = std::vector<float> (*)(std::size_t, std::mt19937&, const Options&);
+
+struct Distribution {
+    const char* name;
+    Generator   generate;
+};
+
+const Distribution kDistributions[] = {
+    { "uniform",        [](std::size_t n, std::mt19937& gen, const Options&) { return uniformPoints(n, gen); } },
+    { "clustered",      [](std::size_t n, std::mt19937& gen, const Options&) { return clusteredPoints(n, gen); } },
+    { "grid",           [](std::size_t n, std::mt19937& gen, const Options&) { return gridPoints(n, gen); } },
+    { "near-collinear", [](std::size_t n, std::mt19937& gen, const Options&) { return nearCollinearPoints(n, gen); } },
+    { "stars",          [](std::size_t n, std::mt19937& gen, const Options& o) { return starPoints(n, gen, o.frames); } },
+};
+
+template <typename D>
+nlohmann::json run(const char* distribution, const std::vector<float>& points, const Options& options) {
+    using Scalar = typename D::scalar_type;
+    const std::vector<Scalar> coords(points.begin(), points.end());
+
+    try {
+        return measure<D>(coords, options);
+    } catch (const std::exception& e) {
+        std::cerr << distribution << ": " << e.what() << '\n';
+        return { { "error", e.what() } };
+    }
+}
+
+bool parseArgs(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (i + 1 >= argc) return false;
+
+        if (arg == "--trace") {
+            options.trace = argv[++i];
+            continue;
+        }
+
+        char* end = nullptr;
+        const unsigned long long value = std::strtoull(argv[++i], &end, 10);
+        if (*end != '\0') return false;
+
+        if (arg == "--max-points") {
+            options.maxPoints = static_cast<std::size_t>(value);
+        } else if (arg == "--threads") {
+            options.threads = static_cast<std::size_t>(value);
+        } else if (arg == "--frames") {
+            options.frames = static_cast<int>(value);
+        } else if (arg == "--seed") {
+            options.seed = static_cast<unsigned>(value);
+        } else {
+            return false;
+        }
+    }
+    return options.maxPoints >= 100;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArgs(argc, argv, options)) {
+        std::cerr << "usage: delaunator_bench [--max-points N] [--threads N] [--frames N] [--seed N]\n"
+                     "       delaunator_bench --trace FILE [--threads N]\n"
+                     "  --max-points  largest point count, at least 100 (default 1000000)\n"
+                     "  --threads     Delaunator::update threads, 0 = hardware (default 1)\n"
+                     "  --frames      moveStars frames before the stars are sampled (default 600)\n"
+                     "  --seed        random seed (default 1)\n"
+                     "  --trace       replay a recorded input trace and time every frame\n";
+        return 1;
+    }
+    if (options.threads == 0) {
+        options.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    if (!options.trace.empty()) {
+        try {
+            std::cout << replayTrace(options).dump(2) << '\n';
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << '\n';
+            return 1;
+        }
+        return 0;
+    }
+
+    nlohmann::json report = {
+        { "benchmark", "delaunator" },
+        { "threads", options.threads },
+        { "frames", options.frames },
+        { "seed", options.seed },
+        { "results", nlohmann::json::array() }
+    };
+
+    for (const Distribution& distribution : kDistributions) {
+        for (std::size_t n = 100; n <= options.maxPoints; n *= 10) {
+            std::mt19937 gen(options.seed);
+            const std::vector<float> points = distribution.generate(n, gen, options);
+
+            nlohmann::json entry = {
+                { "distribution", distribution.name },
+                { "points", n },
+                { "double", run<delaunator::Delaunator>(distribution.name, points, options) },
+                { "float", run<delaunator::Delaunator32>(distribution.name, points, options) }
+            };
+
+            if (std::string_view(distribution.name) == "stars") {
+                std::mt19937 motionGen(options.seed);
+                entry["double"]["motion"] = measureMotion<delaunator::Delaunator, double>(n, motionGen, options);
+                std::mt19937 motionGen32(options.seed);
+                entry["float"]["motion"] = measureMotion<delaunator::Delaunator32, float>(n, motionGen32, options);
+
+                // below 1 when repair() beats a warm update(); a repair that keeps giving
+                // up only adds its own scans to the update it falls back to
+                for (const char* scalar : { "double", "float" }) {
+                    nlohmann::json& result = entry[scalar];
+                    if (result.contains("update")) {
+                        result["motion"]["repair_update_ratio"] =
+                            result["motion"]["ns_per_point"].get<double>() / result["update"]["ns_per_point"].get<double>();
+                    }
+                }
+            }
+
+            report["results"].push_back(std::move(entry));
+            std::cerr << distribution.name << ' ' << n << " done\n";
+        }
+    }
+
+    std::cout << report.dump(2) << '\n';
+    return 0;
+}
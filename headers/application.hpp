@@ -2,6 +2,7 @@
 
 #include <atomic>
 #include <chrono>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -9,11 +10,9 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
-#include <delaunator/delaunator.hpp>
-
 #include <settings.hpp>
 #include <types.hpp>
-#include <star_system.hpp>
+#include <simulation_thread.hpp>
 #include <renderer.hpp>
 #include <raii.hpp>
 #include <wallpaper-host/desktop_utils.hpp>
@@ -54,6 +53,7 @@ private:
     void initOpenGL();
     void initTrayAndWallpaper();
     void mainLoop();
+    void publishSources();
 
     [[nodiscard]] static HICON loadIconFromResource();
 
@@ -61,11 +61,10 @@ private:
     GlfwContext   glfwContext_{};
     Settings&     settings_;
     Window        window_;
-    StarSystem    starSystem_;
 
-    std::vector<double> coords_;
-    std::vector<Vertex> vertices_;
-    Renderer            renderer_;
+    std::unique_ptr<SimulationThread> simulation_;
+    std::vector<InteractionSource>    sources_;
+    Renderer                          renderer_;
 
     std::wstring originalWallpaper_;
     WinMenu      trayMenu_{};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <types.hpp>
+#include <star.hpp>
+
+namespace delaunay_flow {
+
+/**
+ * Divergence-free velocity field for Motion::Flow: the curl of a smooth noise
+ * potential, tabulated on a coarse grid over the bounds so stars read a table
+ * instead of evaluating noise. Every `refresh` seconds a new noise layer takes
+ * over, cross-faded from the previous one, so the currents drift slowly; the
+ * layer after it is built a few rows per advance() meanwhile, so no single step
+ * pays for a whole table. The potential fades to zero at the bounds, which turns
+ * the flow along the edges instead of out of them.
+ */
+class FlowField {
+public:
+    /** Build the first two layers over `bounds`; `scale` is about the size of one swirl. */
+    void reset(const Rect& bounds, float scale, float refresh, std::uint32_t seed);
+
+    /** Move the field's clock on by `dt` seconds and build the next layer's rows that are due. */
+    void advance(float dt);
+
+    /** The two current layers and how far the cross-fade is; valid until the next advance() or reset(). */
+    [[nodiscard]] FlowTable table() const noexcept;
+
+private:
+    void buildLayer(std::uint32_t layer, std::vector<float>& vx, std::vector<float>& vy) const;
+    void buildRows(std::uint32_t layer, std::vector<float>& vx, std::vector<float>& vy,
+                   int begin, int end, float& totalSpeed) const;
+    void buildNext(int rows);
+
+    [[nodiscard]] float potential(float x, float y, std::uint32_t layer) const noexcept;
+
+    Rect          bounds_{};
+    float         scale_{1.0f};
+    float         refresh_{1.0f};
+    float         spacing_{1.0f};
+    int           columns_{0};
+    int           rows_{0};
+    std::uint32_t seed_{0};
+    std::uint32_t layer_{0};     // the layer fading out; layer_ + 1 is fading in
+    float         time_{0.0f};   // seconds into the current cross-fade
+
+    std::vector<float> fromX_;   // layer_
+    std::vector<float> fromY_;
+    std::vector<float> toX_;     // layer_ + 1
+    std::vector<float> toY_;
+    std::vector<float> nextX_;   // layer_ + 2, complete up to nextRows_
+    std::vector<float> nextY_;
+    int                nextRows_{0};
+    float              nextSpeed_{0.0f};  // summed speed of the rows built so far
+};
+
+}  // namespace delaunay_flow
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <delaunator/delaunator.hpp>
+
+namespace delaunay_flow {
+
+/** One finished simulation frame: star positions and their triangulation. */
+struct FrameSnapshot {
+    std::vector<float>         x;
+    std::vector<float>         y;
+    std::vector<std::uint32_t> triangles;
+    std::vector<std::uint32_t> halfedges;
+
+    [[nodiscard]] delaunator::point_view<float> points() const noexcept {
+        if (x.empty()) {
+            return {};
+        }
+        return { x.data(), y.data(), x.size(), sizeof(float) };
+    }
+};
+
+}  // namespace delaunay_flow
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include <types.hpp>
+
+namespace delaunay_flow {
+
+/** Everything besides the per-frame input that decides how a traced run plays out. */
+struct TraceHeader {
+    std::uint32_t seed{0};
+    std::uint32_t count{0};
+    float         minSpeed{0.0f};
+    float         maxSpeed{0.0f};
+    float         stepRate{0.0f};
+    float         separation{0.0f};
+    float         separationStiffness{0.0f};
+    Motion        motion{Motion::Bounce};
+    float         flowScale{0.0f};
+    float         flowRefresh{0.0f};
+    Rect          bounds{};
+};
+
+/** Input of one simulation frame. */
+struct TraceFrame {
+    float                          frameTime{0.0f};
+    bool                           reset{false};   // stars respawned before this frame
+    std::vector<InteractionSource> sources;
+};
+
+/**
+ * Writes an input trace: a header, then one record per simulation frame with its
+ * duration, reset flag and interaction sources. Values are stored in host byte
+ * order; a cursor-only frame takes 23 bytes.
+ */
+class TraceWriter {
+public:
+    TraceWriter(const std::filesystem::path& file, const TraceHeader& header);
+
+    void write(const TraceFrame& frame);
+
+private:
+    std::ofstream out_;
+};
+
+/** Reads a trace written by TraceWriter back, frame by frame. */
+class TraceReader {
+public:
+    explicit TraceReader(const std::filesystem::path& file);
+
+    [[nodiscard]] const TraceHeader& header() const noexcept { return header_; }
+
+    /** Read the next frame; false at the end of the trace or on a truncated record. */
+    bool next(TraceFrame& frame);
+
+private:
+    std::ifstream in_;
+    TraceHeader   header_;
+};
+
+}  // namespace delaunay_flow
@@ -4,6 +4,8 @@
 #include <GLFW/glfw3.h>
 #include <windows.h>
 
+#include <array>
+#include <cstddef>
 #include <memory>
 #include <vector>
 
@@ -113,6 +115,114 @@ private:
     GLuint id_{0U};
 };
 
+class ElementBuffer {
+public:
+    ElementBuffer();
+    ~ElementBuffer() noexcept;
+
+    ElementBuffer(const ElementBuffer&)            = delete;
+    ElementBuffer& operator=(const ElementBuffer&) = delete;
+
+    ElementBuffer(ElementBuffer&& other) noexcept;
+    ElementBuffer& operator=(ElementBuffer&& other) noexcept;
+
+    // the binding is part of the bound VAO's state
+    void bind() const noexcept;
+
+    template <typename IndexT>
+    void setData(const std::vector<IndexT>& indices, GLenum usage) noexcept;
+
+    [[nodiscard]] GLuint id() const noexcept;
+
+private:
+    void reset() noexcept;
+
+    GLuint id_{0U};
+};
+
+/**
+ * A vertex or index buffer written straight from the CPU every frame. Its storage
+ * is split into kRegions regions used in turn: map() waits on the fence left when
+ * the next region was last drawn, then maps it unsynchronized, so the GPU can keep
+ * reading the other regions while this one is written. GL 3.3 has no persistent
+ * mapping, so each frame maps and unmaps its region.
+ */
+class StreamBuffer {
+public:
+    static constexpr std::size_t kRegions = 3U;
+
+    /** `target` is GL_ARRAY_BUFFER, or GL_ELEMENT_ARRAY_BUFFER for indices. */
+    explicit StreamBuffer(GLenum target = GL_ARRAY_BUFFER);
+    ~StreamBuffer() noexcept;
+
+    StreamBuffer(const StreamBuffer&)            = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    StreamBuffer(StreamBuffer&& other) noexcept;
+    StreamBuffer& operator=(StreamBuffer&& other) noexcept;
+
+    void bind() const noexcept;
+
+    /**
+     * Map the next region with room for `count` elements. A region too small for
+     * them grows the whole buffer first. Returns nullptr when there is nothing to
+     * map or mapping failed; unmap() is still due either way.
+     */
+    template <typename T>
+    [[nodiscard]] T* map(std::size_t count);
+
+    /** Finish writing. Returns false when the written data was lost and must not be drawn. */
+    bool unmap() noexcept;
+
+    /**
+     * Element index of the mapped region's start: the `first` of glDrawArrays(),
+     * or times sizeof(T) the byte offset for glVertexAttribPointer()/glDrawElements().
+     */
+    template <typename T>
+    [[nodiscard]] GLint first() const noexcept;
+
+    /** Mark the current region busy until the draw calls issued so far complete. */
+    void fence() noexcept;
+
+private:
+    void* mapBytes(std::size_t bytes, std::size_t stride);
+    void  clearFences() noexcept;
+    void  reset() noexcept;
+
+    GLuint                        id_{0U};
+    GLenum                        target_{GL_ARRAY_BUFFER};
+    std::size_t                   regionBytes_{0U};
+    std::size_t                   region_{0U};
+    bool                          mapped_{false};
+    bool                          mapFailed_{false};  // a map() of bytes > 0 returned nullptr
+    std::array<GLsync, kRegions>  fences_{};
+};
+
+/** A buffer texture: a buffer object read by shaders through texelFetch() on a samplerBuffer. */
+class TextureBuffer {
+public:
+    explicit TextureBuffer(GLenum format);
+    ~TextureBuffer() noexcept;
+
+    TextureBuffer(const TextureBuffer&)            = delete;
+    TextureBuffer& operator=(const TextureBuffer&) = delete;
+
+    TextureBuffer(TextureBuffer&& other) noexcept;
+    TextureBuffer& operator=(TextureBuffer&& other) noexcept;
+
+    // bind the texture to texture unit `unit`
+    void bind(GLuint unit) const noexcept;
+
+    template <typename TexelT>
+    void setData(const std::vector<TexelT>& texels, GLenum usage) noexcept;
+
+private:
+    void reset() noexcept;
+
+    GLuint buffer_{0U};
+    GLuint texture_{0U};
+};
+
 class WinIcon {
 public:
     WinIcon() = default;
@@ -167,4 +277,37 @@ void ArrayBuffer::setData(const std::vector<VertexT>& vertices, GLenum usage) no
     );
 }
 
+template <typename IndexT>
+void ElementBuffer::setData(const std::vector<IndexT>& indices, GLenum usage) noexcept {
+    bind();
+    glBufferData(
+        GL_ELEMENT_ARRAY_BUFFER,
+        static_cast<GLsizeiptr>(indices.size() * sizeof(IndexT)),
+        indices.data(),
+        usage
+    );
+}
+
+template <typename T>
+T* StreamBuffer::map(std::size_t count) {
+    return static_cast<T*>(mapBytes(count * sizeof(T), sizeof(T)));
+}
+
+template <typename T>
+GLint StreamBuffer::first() const noexcept {
+    return static_cast<GLint>(region_ * regionBytes_ / sizeof(T));
+}
+
+template <typename TexelT>
+void TextureBuffer::setData(const std::vector<TexelT>& texels, GLenum usage) noexcept {
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer_);
+    glBufferData(
+        GL_TEXTURE_BUFFER,
+        static_cast<GLsizeiptr>(texels.size() * sizeof(TexelT)),
+        texels.data(),
+        usage
+    );
+    glBindBuffer(GL_TEXTURE_BUFFER, 0U);
+}
+
 } // namespace delaunay_flow
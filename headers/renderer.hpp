@@ -1,14 +1,16 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 #include <glad/glad.h>
 
 #include <types.hpp>
 #include <settings.hpp>
-#include <color_interpolation.hpp>
 #include <raii.hpp>
-#include <star_system.hpp>
+#include <frame_snapshot.hpp>
+#include <thread_pool.hpp>
 
 #include <delaunator/delaunator.hpp>
 
@@ -26,50 +28,96 @@ public:
     Renderer(Renderer&&)            = default;
     Renderer& operator=(Renderer&&) = default;
 
-    void rebuildStaticData(const Settings&              settings,
-                           const StarSystem&            starSystem,
-                           std::vector<double>&         coords,
-                           std::vector<Vertex>&         vertices);
-
-    void updateFrameGeometry(const Settings&    settings,
-                             const StarSystem&  starSystem,
-                             const std::vector<double>& coords,
-                             std::vector<Vertex>&      vertices,
-                             delaunator::Delaunator&   delaunator);
-
-    void uploadVertices(const std::vector<Vertex>& vertices) noexcept;
-
-    void render(float mouseX, float mouseY) const noexcept;
+    /**
+     * Write the frame's edges and stars straight into the next region of the
+     * streaming vertex buffer, and the triangle corners into the next region of
+     * the mesh positions when not indexed.
+     * Every stage's output size is worked out first, so with several render threads
+     * each chunk of triangles, halfedges or stars fills its own slice in parallel.
+     */
+    void updateFrameGeometry(const Settings&      settings,
+                             const FrameSnapshot& frame);
+
+    /**
+     * Upload the triangle mesh, positions only: the shaders color each triangle
+     * from the background gradient at its centroid. Indexed mode sends one position
+     * per star and the frame's triangle list as the element buffer, each into the
+     * next region of its streaming buffer; otherwise the three corners of every
+     * triangle, which updateFrameGeometry() already wrote.
+     */
+    void uploadMesh(const FrameSnapshot& frame) noexcept;
+
+    /** Draw the last uploaded frame, then fence the buffer regions it read. */
+    void render(float mouseX, float mouseY) noexcept;
 
 private:
     void initState(const Settings& settings,
                    float screenWidth,
                    float screenHeight);
 
-    void insertTriangles(delaunator::Delaunator& d,
-                         std::vector<Vertex>&    vertices) const;
-
-    void insertStars(const Settings&   settings,
-                     const StarSystem& starSystem,
-                     std::vector<Vertex>& vertices) const;
-
-    void insertLines(const Settings&   settings,
-                     delaunator::Delaunator& d,
-                     std::vector<Vertex>&    vertices) const;
+    // run func over [0, count) on the pool, or inline without one
+    void parallelFor(std::size_t count, std::size_t grain, const ThreadPool::RangeFunc& func);
+
+    // corners of triangle vertices [begin, end) to xs[k] / ys[k]
+    static void insertTriangles(const FrameSnapshot& frame, std::size_t begin, std::size_t end,
+                                float* xs, float* ys);
+
+    // stars [begin, end), or the edges of halfedges [begin, end), written from `out` on
+    void insertStars(const Settings&      settings,
+                     const FrameSnapshot& frame,
+                     std::size_t          begin,
+                     std::size_t          end,
+                     Vertex*              out) const;
+
+    // built with AVX2, edges are gathered 8 at a time and extruded together
+    void insertLines(const Settings&      settings,
+                     const FrameSnapshot& frame,
+                     std::size_t          begin,
+                     std::size_t          end,
+                     Vertex*              out) const;
+
+    // the quad of the edge from star a to star b, as two triangles from `out` on
+    Vertex* extrudeEdge(const FrameSnapshot& frame,
+                        std::size_t          a,
+                        std::size_t          b,
+                        const Color&         color,
+                        Vertex*              out) const;
+
+    // whether halfedge e is the one that draws its edge: interior, the lower of
+    // the pair, and of nonzero length
+    [[nodiscard]] static bool drawsEdge(const FrameSnapshot& frame, std::size_t e) noexcept;
 
     [[nodiscard]] static std::size_t nextHalfedge(std::size_t e) noexcept;
 
+    [[nodiscard]] static GLint initProgramUniforms(GLuint          program,
+                                                   const Settings& settings,
+                                                   float           aspectRatio,
+                                                   float           screenWidth,
+                                                   float           screenHeight);
+
 private:
-    VertexArray vao_{};
-    ArrayBuffer vbo_{};
-    GLProgram  program_;
+    VertexArray  vao_{};
+    StreamBuffer vbo_{};
+    GLProgram    program_;
 
-    GLint aspectRatioLocation_{-1};
     GLint mousePosLocation_{-1};
-    GLint mouseBarrierRadiusLocation_{-1};
-    GLint displayBoundsLocation_{-1};
-    GLint mouseBarrierColorLocation_{-1};
-    GLint mouseBarrierBlurLocation_{-1};
+
+    // the triangles: positions only, colored by the mesh program's geometry shader;
+    // in indexed mode drawn from shared star positions
+    bool          indexedMesh_{false};
+    VertexArray   meshVao_{};
+    StreamBuffer  meshPositions_{};                 // per region every x, then every y
+    StreamBuffer  meshIndices_{GL_ELEMENT_ARRAY_BUFFER};
+    TextureBuffer gradientStops_{GL_RGBA32F};       // Settings::backGroundColors
+    GLProgram     meshProgram_;
+    GLint         meshMousePosLocation_{-1};
+    std::size_t   meshVertexCount_{0};              // in the current positions region
+    bool          meshWritten_{false};              // its regions unmapped intact
+    std::size_t   meshDrawCount_{0};                // indices, or vertices when not indexed
+    GLint         meshFirstIndex_{0};               // of the index region meshDrawCount_ was written to
+
+    std::unique_ptr<ThreadPool> pool_;              // null with one render thread
+    std::vector<std::size_t>    lineOffsets_;       // first edge vertex of each halfedge chunk
 
     float screenWidth_{};
     float screenHeight_{};
@@ -82,7 +130,8 @@ private:
 
     float halfEdgeWidth_{};
 
-    size_t verticesCount;
+    size_t verticesCount{0};
+    GLint  firstVertex_{0};                         // of the region verticesCount was written to
 };
 
 } // namespace delaunay_flow
\ No newline at end of file
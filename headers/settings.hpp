@@ -47,6 +47,7 @@ public:
     struct Interaction {
         bool mouseInteraction = false;
         float distanceFromMouse = 0.0f;
+        std::vector<InteractionSource> sources;   // y in [-1, 1], x in [-aspect, aspect]
     } interaction;
 
     struct Barrier {
@@ -56,8 +57,28 @@ public:
         float blur = 0.0f;
     } barrier;
 
+    struct Simulation {
+        float rate = 60.0f;
+        int threads = 1;
+        unsigned seed = 0;
+        float separation = 0.0f;
+        float separationStiffness = 0.5f;
+        Motion motion = Motion::Bounce;
+        float flowScale = 0.5f;
+        float flowRefresh = 8.0f;
+        TraceMode traceMode = TraceMode::Off;
+        std::string traceFile;
+    } simulation;
+
+    struct Triangulation {
+        bool kinetic = false;
+        int threads = 1;
+    } triangulation;
+
     float offsetBounds = 0.0f;
     int MSAA = 1;
+    bool indexedMesh = false;
+    int renderThreads = 1;
 };
 
 }  // namespace delaunay_flow
@@ -8,4 +8,7 @@ namespace delaunay_flow {
 /** Compile and link vertex + fragment GLSL shaders; returns program id or 0 on failure. */
 GLuint compileShaders(const char* vertexCode, const char* fragmentCode);
 
+/** Same with a geometry shader between the two stages. */
+GLuint compileShaders(const char* vertexCode, const char* geometryCode, const char* fragmentCode);
+
 }  // namespace delaunay_flow
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include <types.hpp>
+#include <star_system.hpp>
+#include <frame_snapshot.hpp>
+#include <triple_buffer.hpp>
+#include <input_trace.hpp>
+
+#include <delaunator/delaunator.hpp>
+
+namespace delaunay_flow {
+
+/**
+ * Runs the star simulation and triangulation on a thread of its own and
+ * publishes every finished frame through a triple buffer, so the render thread
+ * only has to pick up the newest snapshot, build geometry and draw. The worker
+ * stays one frame ahead of the renderer: it starts the next frame as soon as
+ * the previous one has been acquired.
+ */
+class SimulationThread {
+public:
+    /**
+     * With TraceMode::Record every frame's input is logged to `traceFile`; with
+     * TraceMode::Replay the star parameters, seed and bounds come from that trace
+     * and its frames replace the clock and setSources(), until the trace ends and
+     * the last frame stays up.
+     */
+    SimulationThread(const StarSystemParams& params, Rect bounds,
+                     bool kinetic, std::size_t triangulationThreads,
+                     TraceMode traceMode = TraceMode::Off,
+                     const std::filesystem::path& traceFile = {});
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread&)            = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    /**
+     * Interaction sources (cursor, touch points, attractors) in simulation
+     * coordinates; the worker picks up the newest list at the start of each frame.
+     */
+    void setSources(std::span<const InteractionSource> sources);
+
+    /** Ask the worker to respawn the stars before its next frame. */
+    void requestReset() noexcept;
+
+    /**
+     * Render thread: pick up the newest snapshot; false if nothing new was published.
+     * Rethrows the exception that stopped the worker (a failed triangulation or
+     * trace I/O error), so it reaches the render thread's handler.
+     */
+    bool acquire();
+
+    /** Render thread: the snapshot taken by the last successful acquire(). */
+    [[nodiscard]] const FrameSnapshot& snapshot() const noexcept { return snapshots_.front(); }
+
+private:
+    void run(const std::stop_token& stop);
+    bool nextFrame(TraceFrame& frame, std::chrono::steady_clock::time_point& previous);
+    void publish();
+
+    std::unique_ptr<TraceReader> replay_;    // declared before starSystem_, which it configures
+    StarSystem                   starSystem_;
+    std::unique_ptr<TraceWriter> recorder_;
+
+    delaunator::Delaunator32 delaunator_;
+    bool                     kinetic_;
+    std::size_t              triangulationThreads_;
+
+    std::atomic<bool> resetRequested_{false};
+
+    // set by the worker before it stops; failed_ publishes error_ to the render thread
+    std::exception_ptr error_;
+    std::atomic<bool>  failed_{false};
+
+    TripleBuffer<std::vector<InteractionSource>> sources_;
+    TripleBuffer<FrameSnapshot>                  snapshots_;
+
+    // declared last so the worker is joined before anything it uses is destroyed
+    std::jthread worker_;
+};
+
+}  // namespace delaunay_flow
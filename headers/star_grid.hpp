@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <types.hpp>
+#include <star.hpp>
+
+namespace delaunay_flow {
+
+/**
+ * Uniform grid over the star bounds with the stars binned by cell, so queries
+ * around a point only visit the stars in the cells it overlaps. Rebuilding is a
+ * counting sort over the cell ids and doesn't allocate once the grid has grown.
+ */
+class StarGrid {
+public:
+    /**
+     * Bin every star into square cells of at least `cellSize` covering `bounds`.
+     * Stars slightly outside the bounds land in the border cells.
+     */
+    void rebuild(const Stars& stars, const Rect& bounds, float cellSize);
+
+    /** Call func(cell) for every cell overlapping the square of half-size `radius` around (x, y). */
+    template <typename Func>
+    void forEachCellNear(float x, float y, float radius, Func&& func) const {
+        if (columns_ == 0) {
+            return;
+        }
+
+        const int col0 = cellColumn(x - radius);
+        const int col1 = cellColumn(x + radius);
+        const int row0 = cellRow(y - radius);
+        const int row1 = cellRow(y + radius);
+
+        for (int row = row0; row <= row1; ++row) {
+            for (int col = col0; col <= col1; ++col) {
+                func(static_cast<std::uint32_t>(row * columns_ + col));
+            }
+        }
+    }
+
+    /** Star ids binned into `cell`. */
+    [[nodiscard]] std::span<const std::uint32_t> cellStars(std::uint32_t cell) const noexcept {
+        return { starIds_.data() + cellStart_[cell], starIds_.data() + cellStart_[cell + 1U] };
+    }
+
+private:
+    [[nodiscard]] int cellColumn(float x) const noexcept {
+        return std::clamp(static_cast<int>((x - bounds_.left) * invCellSize_), 0, columns_ - 1);
+    }
+    [[nodiscard]] int cellRow(float y) const noexcept {
+        return std::clamp(static_cast<int>((y - bounds_.bottom) * invCellSize_), 0, rows_ - 1);
+    }
+
+    Rect  bounds_{};
+    float invCellSize_{0.0f};
+    int   columns_{0};
+    int   rows_{0};
+
+    std::vector<std::uint32_t> cellStart_;   // star ids of cell c are starIds_[cellStart_[c], cellStart_[c + 1])
+    std::vector<std::uint32_t> starIds_;
+    std::vector<std::uint32_t> starCell_;
+};
+
+}  // namespace delaunay_flow
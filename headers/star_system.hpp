@@ -1,36 +1,101 @@
 #pragma once
 
 #include <random>
+#include <memory>
 #include <vector>
 #include <chrono>
+#include <cstdint>
+#include <span>
 
 #include <types.hpp>
 #include <settings.hpp>
 #include <star.hpp>
+#include <star_grid.hpp>
+#include <flow_field.hpp>
+#include <thread_pool.hpp>
+#include <input_trace.hpp>
+
+#include <delaunator/delaunator.hpp>
 
 namespace delaunay_flow {
 
+/** Everything one star system needs; independent systems can use different values. */
+struct StarSystemParams {
+    int           count               = 0;
+    float         minSpeed            = 0.0f;
+    float         maxSpeed            = 0.0f;
+    float         stepRate            = 60.0f; // fixed simulation steps per second
+    std::uint32_t seed                = 0;     // star layout seed, 0 draws one from std::random_device
+    float         separation          = 0.0f;  // Delaunay neighbors closer than this are pushed apart, 0 = off
+    float         separationStiffness = 0.5f;  // share of the overlap removed per step, in (0, 1]
+    Motion        motion              = Motion::Bounce;
+    float         flowScale           = 0.5f;  // rough size of one flow swirl, Motion::Flow only
+    float         flowRefresh         = 8.0f;  // seconds until the flow field has changed over
+    std::size_t   threads             = 1;     // update threads, the caller included
+};
+
+[[nodiscard]] StarSystemParams starSystemParams(const Settings& settings);
+
+// the parameters a trace was recorded with; only the thread count is chosen locally
+[[nodiscard]] StarSystemParams starSystemParams(const TraceHeader& header, std::size_t threads);
+
 class StarSystem {
 public:
-    StarSystem(const Settings& settings, Rect bounds);
+    StarSystem(const StarSystemParams& params, Rect bounds);
 
-    StarSystem(const StarSystem&) = delete;
-    StarSystem& operator=(const StarSystem& other) {
-        if (this != &other) {
-            stars_ = other.stars_;
-            bounds_ = other.bounds_;
-        }
-        return *this;
-    }
+    StarSystem(const StarSystem&)            = delete;
+    StarSystem& operator=(const StarSystem&) = delete;
 
     StarSystem(StarSystem&&)            = default;
     StarSystem& operator=(StarSystem&&) = default;
 
     void reset();
-    void update(std::chrono::duration<float> dt, float mouseXNDC, float mouseYNDC);
 
-    [[nodiscard]] const std::vector<Star>& stars() const noexcept { return stars_; }
-    [[nodiscard]] std::vector<Star>&       stars() noexcept       { return stars_; }
+    /**
+     * Advance the simulation clock by one rendered frame. Stars move only in whole
+     * fixed steps of 1 / stepRate, however long the frame took; the time left over
+     * is kept for the next frame and used to blend the last two states, so
+     * positions() is smooth at any render rate. A backlog of more than a few steps
+     * (sleep, a locked screen, a hidden window) is skipped with fastForward(), and
+     * only the last step is run normally.
+     */
+    void advance(std::chrono::duration<float> frameTime, std::span<const InteractionSource> sources);
+
+    /**
+     * Jump ahead by `time` in one O(n) pass, putting the stars where stepping would
+     * have, however long that is. Interaction sources and the separation force are
+     * left out, and the neighbor graph is dropped until the next setNeighbors().
+     * Flow paths have no closed form, so with Motion::Flow the time is skipped and
+     * the stars stay where they are.
+     */
+    void fastForward(std::chrono::duration<double> time);
+
+    // one fixed step, bouncing or following the flow field; with several threads the
+    // stars are split into fixed ranges, and since stars don't interact the result
+    // doesn't depend on the split.
+    // Interaction sources then only visit the grid cells around them
+    void step(std::span<const InteractionSource> sources);
+
+    /**
+     * Neighbor graph for the separation force: the triangulation of the current
+     * positions, from which every Delaunay edge is taken once. The edges are kept
+     * until the next call, so steps run before the next triangulation reuse them.
+     */
+    void setNeighbors(std::span<const std::uint32_t> triangles, std::span<const std::uint32_t> halfedges);
+
+    [[nodiscard]] const Stars& stars() const noexcept { return stars_; }
+    [[nodiscard]] Stars&       stars() noexcept       { return stars_; }
+
+    [[nodiscard]] const StarSystemParams& params() const noexcept { return params_; }
+
+    // the seed actually in use, drawn at construction when params().seed is 0
+    [[nodiscard]] std::uint32_t seed() const noexcept { return seed_; }
+
+    // star positions blended between the last two steps; valid until the next advance()
+    [[nodiscard]] delaunator::point_view<float> positions() const noexcept;
+
+    // how far the render time is past the last step, in [0, 1)
+    [[nodiscard]] float interpolation() const noexcept { return alpha_; }
 
     [[nodiscard]] float left() const noexcept   { return bounds_.left; }
     [[nodiscard]] float right() const noexcept  { return bounds_.right; }
@@ -38,9 +103,37 @@ public:
     [[nodiscard]] float top() const noexcept    { return bounds_.top; }
 
 private:
-    std::vector<Star> stars_{};
-    Rect              bounds_;
-    const Settings&   settings_;
+    [[nodiscard]] float randomUniform(float start, float end);
+
+    void skipSteps(std::uint64_t steps);
+    void interpolate();
+    void applySources(std::span<const InteractionSource> sources);
+    [[nodiscard]] float separate();
+
+    Stars                       stars_{};
+    std::vector<float>          prevX_;     // positions before the last step
+    std::vector<float>          prevY_;
+    std::vector<float>          drawX_;     // positions handed to the renderer
+    std::vector<float>          drawY_;
+    float                       stepTime_;
+    float                       accumulator_{0.0f};
+    float                       alpha_{0.0f};
+    Rect                        bounds_;
+    StarSystemParams            params_;
+    StarGrid                    grid_;
+    float                       gridCellSize_{0.0f};
+    float                       gridSlack_{0.0f};  // how far stars may be from their grid cells
+    std::vector<std::uint64_t>  sourceCells_;      // (cell << 32 | source) for every cell a source reaches
+    std::vector<std::uint32_t>  edges_;            // Delaunay edges as (a, b) pairs
+    std::vector<float>          shiftX_;           // separation pushes gathered per star
+    std::vector<float>          shiftY_;
+    FlowField                   flow_;
+    std::uint32_t               seed_;
+    std::mt19937                gen_;
+    std::unique_ptr<ThreadPool> pool_;
 };
 
+// what a trace needs to reproduce this system's stars
+[[nodiscard]] TraceHeader traceHeader(const StarSystem& starSystem);
+
 } // namespace delaunay_flow
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace delaunay_flow {
+
+/**
+ * Fixed set of worker threads for data-parallel loops. The calling thread takes
+ * part in every loop, so a pool of size 1 has no workers and runs inline.
+ */
+class ThreadPool {
+public:
+    using RangeFunc = std::function<void(std::size_t begin, std::size_t end)>;
+
+    explicit ThreadPool(std::size_t threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&)                 = delete;
+    ThreadPool& operator=(ThreadPool&&)      = delete;
+
+    /** Threads taking part in a loop, the caller included. */
+    [[nodiscard]] std::size_t size() const noexcept { return workers_.size() + 1; }
+
+    /**
+     * Split [0, count) into at most size() contiguous ranges whose boundaries are
+     * multiples of `grain`, run func on each and return once all have finished.
+     * The split depends only on count, grain and size().
+     */
+    void parallelFor(std::size_t count, std::size_t grain, const RangeFunc& func);
+
+private:
+    void workerLoop(std::size_t index);
+    void runRange(std::size_t index) const;
+
+    std::mutex              mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+
+    const RangeFunc* func_{nullptr};
+    std::size_t      count_{0};
+    std::size_t      chunk_{0};
+    std::size_t      generation_{0};
+    std::size_t      pending_{0};
+    bool             stop_{false};
+
+    // declared last so the workers are joined before the state they wait on is destroyed
+    std::vector<std::jthread> workers_;
+};
+
+}  // namespace delaunay_flow
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <stop_token>
+
+namespace delaunay_flow {
+
+/**
+ * Single-producer, single-consumer triple buffer. The writer fills back(), then
+ * publish() swaps it with the shared middle slot; the reader's acquire() swaps
+ * the middle slot into front() whenever something new was published. Neither
+ * side ever touches the other's slot, and both swaps are one atomic exchange,
+ * so nothing blocks and the reader always sees the newest complete value.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+
+    TripleBuffer(const TripleBuffer&)            = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    /** Writer side: the slot being filled. */
+    [[nodiscard]] T& back() noexcept { return slots_[back_]; }
+
+    /** Writer side: hand back() to the reader and take over the stale middle slot. */
+    void publish() noexcept {
+        const std::uint8_t previous = middle_.exchange(
+            static_cast<std::uint8_t>(back_ | kFresh), std::memory_order_acq_rel);
+        back_ = previous & kIndexMask;
+        middle_.notify_one();
+    }
+
+    /**
+     * Writer side: block until the reader has taken the last published value or
+     * a stop is requested, so the writer runs at most one value ahead.
+     */
+    void waitForReader(const std::stop_token& stop) const noexcept {
+        std::uint8_t state = middle_.load(std::memory_order_acquire);
+        while ((state & kFresh) != 0 && !stop.stop_requested()) {
+            middle_.wait(state, std::memory_order_acquire);
+            state = middle_.load(std::memory_order_acquire);
+        }
+    }
+
+    /** Reader side: move the newest published value into front(); false if there was none. */
+    bool acquire() noexcept {
+        if ((middle_.load(std::memory_order_relaxed) & kFresh) == 0) {
+            return false;
+        }
+        const std::uint8_t previous = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = previous & kIndexMask;
+        middle_.notify_one();
+        return true;
+    }
+
+    /** Reader side: the most recently acquired value. */
+    [[nodiscard]] const T& front() const noexcept { return slots_[front_]; }
+
+private:
+    static constexpr std::uint8_t kIndexMask = 0x3U;
+    static constexpr std::uint8_t kFresh     = 0x4U;
+
+    std::array<T, 3>          slots_{};
+    std::uint8_t              back_{0};
+    std::atomic<std::uint8_t> middle_{1};
+    std::uint8_t              front_{2};
+};
+
+}  // namespace delaunay_flow
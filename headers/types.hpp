@@ -35,4 +35,38 @@ struct Rect {
     Rect() : left(0.0f), right(0.0f), bottom(0.0f), top(0.0f) {}
 };
 
+/** How a source's pull or push fades from its center (t = 0) to its radius (t = 1). */
+enum class Falloff {
+    Hard,    // full strength everywhere inside the radius
+    Linear,  // 1 - t
+    Smooth   // (1 - t^2)^2
+};
+
+/**
+ * Something that pushes stars away (strength > 0) or pulls them in (strength < 0)
+ * within `radius` of (x, y): the cursor, a touch point, a scripted attractor.
+ * Strength 1 with a hard falloff moves stars right to the edge, like the classic
+ * mouse barrier; strength -1 moves them right onto the center.
+ */
+struct InteractionSource {
+    float   x{0.0f};
+    float   y{0.0f};
+    float   radius{0.0f};
+    float   strength{0.0f};   // in [-1, 1]
+    Falloff falloff{Falloff::Hard};
+};
+
+/** How star origins travel. */
+enum class Motion {
+    Bounce,  // straight lines, reflected at the bounds
+    Flow     // along a slowly changing curl-noise flow field
+};
+
+/** What the simulation does with its input trace file. */
+enum class TraceMode {
+    Off,
+    Record,  // log every frame's duration and interaction sources
+    Replay   // feed a recorded trace back instead of the clock and live input
+};
+
 }  // namespace delaunay_flow
@@ -1,5 +1,36 @@
 #include "delaunator.hpp"
 
+#include <array>
+#include <atomic>
+#include <bit>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define DELAUNATOR_X86_SIMD
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define DELAUNATOR_TARGET_AVX2
+#define DELAUNATOR_TARGET_AVX512
+#define DELAUNATOR_KERNEL __forceinline
+#else
+#define DELAUNATOR_TARGET_AVX2 __attribute__((target("avx2")))
+#define DELAUNATOR_TARGET_AVX512 __attribute__((target("avx512f")))
+#define DELAUNATOR_KERNEL inline __attribute__((always_inline))
+#endif
+#endif
+
+// the batched kernels must round exactly like the scalar predicates, so nothing here
+// may fuse a multiply and an add: MSVC's /fp:fast and GCC's default -ffp-contract=fast
+// would, at least in the AVX-512 kernels (AVX-512F implies FMA)
+#if defined(_MSC_VER)
+#pragma float_control(precise, on)
+#pragma fp_contract(off)
+#elif defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
 namespace delaunator {
 
 inline size_t fast_mod(const size_t i, const size_t c) {
@@ -91,12 +122,49 @@ std::pair<double, double> circumcenter(
     return std::make_pair(x, y);
 }
 
-bool compare::operator()(std::size_t i, std::size_t j) {
-    const double d1 = dist(coords[2 * i], coords[2 * i + 1], cx, cy);
-    const double d2 = dist(coords[2 * j], coords[2 * j + 1], cx, cy);
+// the O(n) seed search loops: which per-point metric to minimize
+enum class seed_metric {
+    center_dist,   // dist to (ax, ay)
+    seed_dist,     // dist to (ax, ay), excluding coincident points
+    circumradius   // circumradius with (ax, ay), (bx, by)
+};
+
+template <typename Scalar, typename Index>
+Index seed_scan_scalar(
+    point_view<Scalar> const& points,
+    const seed_metric metric,
+    const double ax,
+    const double ay,
+    const double bx,
+    const double by,
+    double& best
+) {
+    Index best_i = std::numeric_limits<Index>::max();
+    for (std::size_t i = 0; i < points.size(); i++) {
+        const double x = points.x(i);
+        const double y = points.y(i);
+        double d;
+        switch (metric) {
+            case seed_metric::center_dist: d = dist(ax, ay, x, y); break;
+            case seed_metric::seed_dist: d = dist(ax, ay, x, y); if (!(d > 0.0f)) continue; break;
+            default: d = circumradius(ax, ay, bx, by, x, y); break;
+        }
+        if (d < best) {
+            best_i = static_cast<Index>(i);
+            best = d;
+        }
+    }
+    return best_i;
+}
+
+template <typename Scalar>
+template <typename Index>
+bool compare<Scalar>::operator()(Index i, Index j) {
+    const double d1 = dist(points.x(i), points.y(i), cx, cy);
+    const double d2 = dist(points.x(j), points.y(j), cx, cy);
     const double diff1 = d1 - d2;
-    const double diff2 = coords[2 * i] - coords[2 * j];
-    const double diff3 = coords[2 * i + 1] - coords[2 * j + 1];
+    const double diff2 = static_cast<double>(points.x(i)) - points.x(j);
+    const double diff3 = static_cast<double>(points.y(i)) - points.y(j);
 
     if (diff1 > 0.0f || diff1 < 0.0f) {
         return diff1 < 0;
@@ -143,95 +211,565 @@ double pseudo_angle(const double dx, const double dy) {
     return (dy > 0.0f ? 3.0f - p : 1.0f + p) / 4.0f; // [0..1)
 }
 
-Delaunator::Delaunator(std::vector<double> const& in_coords)
-    : coords(in_coords),
-      triangles(),
+simd_level detect_simd_level() {
+#ifdef DELAUNATOR_X86_SIMD
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    const int max_leaf = info[0];
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (max_leaf < 7 || !osxsave || !avx) return simd_level::sse2;
+    // the OS has to save the ymm (and for AVX-512 the zmm and mask) registers
+    const unsigned long long xcr0 = _xgetbv(0);
+    if ((xcr0 & 0x6) != 0x6) return simd_level::sse2;
+    __cpuidex(info, 7, 0);
+    if ((xcr0 & 0xE6) == 0xE6 && (info[1] & (1 << 16)) != 0) return simd_level::avx512;
+    return (info[1] & (1 << 5)) != 0 ? simd_level::avx2 : simd_level::sse2;
+#else
+    if (__builtin_cpu_supports("avx512f")) return simd_level::avx512;
+    if (__builtin_cpu_supports("avx2")) return simd_level::avx2;
+    return simd_level::sse2;
+#endif
+#else
+    return simd_level::scalar;
+#endif
+}
+
+std::atomic<simd_level>& active_simd_level() {
+    static std::atomic<simd_level> level{detect_simd_level()};
+    return level;
+}
+
+simd_level get_simd_level() {
+    return active_simd_level().load(std::memory_order_relaxed);
+}
+
+void set_simd_level(simd_level level) {
+    static const simd_level supported = detect_simd_level();
+    active_simd_level().store(std::min(level, supported), std::memory_order_relaxed);
+}
+
+// lanes per batch at each level; the scalar level tests one candidate at a time
+constexpr std::size_t SIMD_MAX_WIDTH = 8;
+
+std::size_t simd_width(const simd_level level) {
+    switch (level) {
+        case simd_level::avx512: return 8;
+        case simd_level::avx2: return 4;
+        case simd_level::sse2: return 2;
+        default: return 1;
+    }
+}
+
+#ifdef DELAUNATOR_X86_SIMD
+
+// the kernels below are templates over these lane types and aren't compiled for any
+// instruction set themselves, which GCC warns would change how vectors are passed.
+// they are always inlined into an entry point with the right target attribute, so no
+// vector is ever passed to or returned from a function compiled without it
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+// double lanes of one instruction set; lane(k) supplies the k-th value of a gather,
+// and comparisons are ordered (false when either side is NaN) like the scalar ones
+struct sse2_lanes {
+    using vec = __m128d;
+    using mask = __m128d;
+    static constexpr std::size_t width = 2;
+
+    template <typename Lane>
+    static vec gather(Lane lane) { return _mm_setr_pd(lane(0), lane(1)); }
+    static vec set1(double v) { return _mm_set1_pd(v); }
+    static vec add(vec a, vec b) { return _mm_add_pd(a, b); }
+    static vec sub(vec a, vec b) { return _mm_sub_pd(a, b); }
+    static vec mul(vec a, vec b) { return _mm_mul_pd(a, b); }
+    static vec div(vec a, vec b) { return _mm_div_pd(a, b); }
+    static mask lt(vec a, vec b) { return _mm_cmplt_pd(a, b); }
+    static mask ne(vec a, vec b) { return _mm_or_pd(_mm_cmplt_pd(a, b), _mm_cmpgt_pd(a, b)); }
+    static mask both(mask a, mask b) { return _mm_and_pd(a, b); }
+    static vec select(mask m, vec a, vec b) { return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b)); }
+    static unsigned bits(mask m) { return static_cast<unsigned>(_mm_movemask_pd(m)); }
+    static void store(double* out, vec v) { _mm_storeu_pd(out, v); }
+};
+
+struct avx2_lanes {
+    using vec = __m256d;
+    using mask = __m256d;
+    static constexpr std::size_t width = 4;
+
+    template <typename Lane>
+    DELAUNATOR_TARGET_AVX2 static vec gather(Lane lane) {
+        return _mm256_setr_pd(lane(0), lane(1), lane(2), lane(3));
+    }
+    DELAUNATOR_TARGET_AVX2 static vec set1(double v) { return _mm256_set1_pd(v); }
+    DELAUNATOR_TARGET_AVX2 static vec add(vec a, vec b) { return _mm256_add_pd(a, b); }
+    DELAUNATOR_TARGET_AVX2 static vec sub(vec a, vec b) { return _mm256_sub_pd(a, b); }
+    DELAUNATOR_TARGET_AVX2 static vec mul(vec a, vec b) { return _mm256_mul_pd(a, b); }
+    DELAUNATOR_TARGET_AVX2 static vec div(vec a, vec b) { return _mm256_div_pd(a, b); }
+    DELAUNATOR_TARGET_AVX2 static mask lt(vec a, vec b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    DELAUNATOR_TARGET_AVX2 static mask ne(vec a, vec b) { return _mm256_cmp_pd(a, b, _CMP_NEQ_OQ); }
+    DELAUNATOR_TARGET_AVX2 static mask both(mask a, mask b) { return _mm256_and_pd(a, b); }
+    DELAUNATOR_TARGET_AVX2 static vec select(mask m, vec a, vec b) { return _mm256_blendv_pd(b, a, m); }
+    DELAUNATOR_TARGET_AVX2 static unsigned bits(mask m) { return static_cast<unsigned>(_mm256_movemask_pd(m)); }
+    DELAUNATOR_TARGET_AVX2 static void store(double* out, vec v) { _mm256_storeu_pd(out, v); }
+};
+
+struct avx512_lanes {
+    using vec = __m512d;
+    using mask = __mmask8;
+    static constexpr std::size_t width = 8;
+
+    template <typename Lane>
+    DELAUNATOR_TARGET_AVX512 static vec gather(Lane lane) {
+        return _mm512_setr_pd(lane(0), lane(1), lane(2), lane(3), lane(4), lane(5), lane(6), lane(7));
+    }
+    DELAUNATOR_TARGET_AVX512 static vec set1(double v) { return _mm512_set1_pd(v); }
+    DELAUNATOR_TARGET_AVX512 static vec add(vec a, vec b) { return _mm512_add_pd(a, b); }
+    DELAUNATOR_TARGET_AVX512 static vec sub(vec a, vec b) { return _mm512_sub_pd(a, b); }
+    DELAUNATOR_TARGET_AVX512 static vec mul(vec a, vec b) { return _mm512_mul_pd(a, b); }
+    DELAUNATOR_TARGET_AVX512 static vec div(vec a, vec b) { return _mm512_div_pd(a, b); }
+    DELAUNATOR_TARGET_AVX512 static mask lt(vec a, vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+    DELAUNATOR_TARGET_AVX512 static mask ne(vec a, vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_NEQ_OQ); }
+    DELAUNATOR_TARGET_AVX512 static mask both(mask a, mask b) { return static_cast<mask>(a & b); }
+    DELAUNATOR_TARGET_AVX512 static vec select(mask m, vec a, vec b) { return _mm512_mask_blend_pd(m, b, a); }
+    DELAUNATOR_TARGET_AVX512 static unsigned bits(mask m) { return m; }
+    DELAUNATOR_TARGET_AVX512 static void store(double* out, vec v) { _mm512_storeu_pd(out, v); }
+};
+
+// the points ids[0] .. ids[width - 1], widened to double
+template <typename V, typename Scalar, typename Index>
+DELAUNATOR_KERNEL void load_lanes(
+    point_view<Scalar> const& points, const Index* ids, typename V::vec& x, typename V::vec& y) {
+    x = V::gather([&](std::size_t k) -> double { return points.x(ids[k]); });
+    y = V::gather([&](std::size_t k) -> double { return points.y(ids[k]); });
+}
+
+// Same operations in the same order as dist and circumradius (no fused
+// multiply-add), and lanes keep their first strict minimum, so the result
+// is the index the scalar loop would pick. The last batch repeats the last
+// point in its spare lanes, which can't change the result.
+template <typename V, typename Scalar, typename Index>
+DELAUNATOR_KERNEL Index seed_scan_lanes(
+    point_view<Scalar> const& points,
+    const seed_metric metric,
+    const double ax,
+    const double ay,
+    const double bx,
+    const double by,
+    double& best
+) {
+    using vec = typename V::vec;
+    const std::size_t n = points.size();
+    const vec vax = V::set1(ax);
+    const vec vay = V::set1(ay);
+    const vec zero = V::set1(0.0);
+    const vec half = V::set1(0.5);
+    const vec none = V::set1(std::numeric_limits<double>::max());
+
+    // circumradius terms that only depend on the first two points
+    const double dx = bx - ax;
+    const double dy = by - ay;
+    const vec vdx = V::set1(dx);
+    const vec vdy = V::set1(dy);
+    const vec vbl = V::set1(dx * dx + dy * dy);
+    const bool bl_valid = dx * dx + dy * dy > 0.0f || dx * dx + dy * dy < 0.0f;
+
+    vec best_v = V::set1(best);
+    vec best_i = V::set1(-1.0);
+    std::size_t ids[V::width];
+
+    for (std::size_t i = 0; i < n; i += V::width) {
+        for (std::size_t k = 0; k < V::width; k++) ids[k] = std::min(i + k, n - 1);
+        vec x;
+        vec y;
+        load_lanes<V>(points, ids, x, y);
+        const vec lane_i = V::gather([&](std::size_t k) { return static_cast<double>(ids[k]); });
+
+        vec d;
+        typename V::mask m;
+        if (metric == seed_metric::circumradius) {
+            const vec ex = V::sub(x, vax);
+            const vec ey = V::sub(y, vay);
+            const vec cl = V::add(V::mul(ex, ex), V::mul(ey, ey));
+            const vec det = V::sub(V::mul(vdx, ey), V::mul(vdy, ex));
+            const vec cx = V::div(V::mul(V::sub(V::mul(ey, vbl), V::mul(vdy, cl)), half), det);
+            const vec cy = V::div(V::mul(V::sub(V::mul(vdx, cl), V::mul(ex, vbl)), half), det);
+            const vec r = V::add(V::mul(cx, cx), V::mul(cy, cy));
+            d = bl_valid ? V::select(V::both(V::ne(cl, zero), V::ne(det, zero)), r, none) : none;
+            m = V::lt(d, best_v);
+        } else {
+            const vec ex = V::sub(vax, x);
+            const vec ey = V::sub(vay, y);
+            d = V::add(V::mul(ex, ex), V::mul(ey, ey));
+            m = V::lt(d, best_v);
+            if (metric == seed_metric::seed_dist) m = V::both(m, V::lt(zero, d));
+        }
+        best_v = V::select(m, d, best_v);
+        best_i = V::select(m, lane_i, best_i);
+    }
+
+    // the smallest value wins; among equal values the lowest index came first
+    double values[V::width];
+    double indices[V::width];
+    V::store(values, best_v);
+    V::store(indices, best_i);
+
+    Index result = std::numeric_limits<Index>::max();
+    double result_i = -1.0;
+    for (std::size_t lane = 0; lane < V::width; lane++) {
+        if (indices[lane] < 0.0) continue;
+        if (result_i < 0.0 || values[lane] < best || (values[lane] == best && indices[lane] < result_i)) {
+            best = values[lane];
+            result_i = indices[lane];
+        }
+    }
+    if (result_i >= 0.0) result = static_cast<Index>(result_i);
+    return result;
+}
+
+// in_circle(a[k], b[k], c[k], p[k]) for each lane k, as bit k of the result
+template <typename V, typename Scalar, typename Index>
+DELAUNATOR_KERNEL unsigned in_circle_lanes(
+    point_view<Scalar> const& points, const Index* a, const Index* b, const Index* c, const Index* p) {
+    using vec = typename V::vec;
+    vec ax, ay, bx, by, cx, cy, px, py;
+    load_lanes<V>(points, a, ax, ay);
+    load_lanes<V>(points, b, bx, by);
+    load_lanes<V>(points, c, cx, cy);
+    load_lanes<V>(points, p, px, py);
+
+    const vec dx = V::sub(ax, px);
+    const vec dy = V::sub(ay, py);
+    const vec ex = V::sub(bx, px);
+    const vec ey = V::sub(by, py);
+    const vec fx = V::sub(cx, px);
+    const vec fy = V::sub(cy, py);
+
+    const vec ap = V::add(V::mul(dx, dx), V::mul(dy, dy));
+    const vec bp = V::add(V::mul(ex, ex), V::mul(ey, ey));
+    const vec cp = V::add(V::mul(fx, fx), V::mul(fy, fy));
+
+    const vec det = V::add(
+        V::sub(V::mul(dx, V::sub(V::mul(ey, cp), V::mul(bp, fy))),
+               V::mul(dy, V::sub(V::mul(ex, cp), V::mul(bp, fx)))),
+        V::mul(ap, V::sub(V::mul(ex, fy), V::mul(ey, fx))));
+    return V::bits(V::lt(det, V::set1(0.0)));
+}
+
+// orient(p, q[k], r[k]) for each lane k, as bit k of the result
+template <typename V, typename Scalar, typename Index>
+DELAUNATOR_KERNEL unsigned orient_lanes(
+    point_view<Scalar> const& points, const double px, const double py, const Index* q, const Index* r) {
+    using vec = typename V::vec;
+    vec qx, qy, rx, ry;
+    load_lanes<V>(points, q, qx, qy);
+    load_lanes<V>(points, r, rx, ry);
+
+    const vec det = V::sub(
+        V::mul(V::sub(qy, V::set1(py)), V::sub(rx, qx)),
+        V::mul(V::sub(qx, V::set1(px)), V::sub(ry, qy)));
+    return V::bits(V::lt(det, V::set1(0.0)));
+}
+
+// entry points compiled for each instruction set above SSE2, which x86-64 always has
+template <typename Scalar, typename Index>
+DELAUNATOR_TARGET_AVX2 Index seed_scan_avx2(
+    point_view<Scalar> const& points, seed_metric metric, double ax, double ay, double bx, double by, double& best) {
+    return seed_scan_lanes<avx2_lanes, Scalar, Index>(points, metric, ax, ay, bx, by, best);
+}
+
+template <typename Scalar, typename Index>
+DELAUNATOR_TARGET_AVX512 Index seed_scan_avx512(
+    point_view<Scalar> const& points, seed_metric metric, double ax, double ay, double bx, double by, double& best) {
+    return seed_scan_lanes<avx512_lanes, Scalar, Index>(points, metric, ax, ay, bx, by, best);
+}
+
+template <typename Scalar, typename Index>
+DELAUNATOR_TARGET_AVX2 unsigned in_circle_avx2(
+    point_view<Scalar> const& points, const Index* a, const Index* b, const Index* c, const Index* p) {
+    return in_circle_lanes<avx2_lanes>(points, a, b, c, p);
+}
+
+template <typename Scalar, typename Index>
+DELAUNATOR_TARGET_AVX512 unsigned in_circle_avx512(
+    point_view<Scalar> const& points, const Index* a, const Index* b, const Index* c, const Index* p) {
+    return in_circle_lanes<avx512_lanes>(points, a, b, c, p);
+}
+
+template <typename Scalar, typename Index>
+DELAUNATOR_TARGET_AVX2 unsigned orient_avx2(
+    point_view<Scalar> const& points, double px, double py, const Index* q, const Index* r) {
+    return orient_lanes<avx2_lanes>(points, px, py, q, r);
+}
+
+template <typename Scalar, typename Index>
+DELAUNATOR_TARGET_AVX512 unsigned orient_avx512(
+    point_view<Scalar> const& points, double px, double py, const Index* q, const Index* r) {
+    return orient_lanes<avx512_lanes>(points, px, py, q, r);
+}
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
+
+// index of the first point minimizing the metric, or INVALID_INDEX if none beats best
+template <typename Scalar, typename Index>
+Index seed_scan(
+    point_view<Scalar> const& points,
+    const seed_metric metric,
+    const double ax,
+    const double ay,
+    const double bx,
+    const double by,
+    double& best
+) {
+    if (points.empty()) return std::numeric_limits<Index>::max();
+    switch (get_simd_level()) {
+#ifdef DELAUNATOR_X86_SIMD
+        case simd_level::avx512:
+            return seed_scan_avx512<Scalar, Index>(points, metric, ax, ay, bx, by, best);
+        case simd_level::avx2:
+            return seed_scan_avx2<Scalar, Index>(points, metric, ax, ay, bx, by, best);
+        case simd_level::sse2:
+            return seed_scan_lanes<sse2_lanes, Scalar, Index>(points, metric, ax, ay, bx, by, best);
+#endif
+        default:
+            return seed_scan_scalar<Scalar, Index>(points, metric, ax, ay, bx, by, best);
+    }
+}
+
+// in_circle for count <= simd_width(level) quadruples at once; bit k of the result is
+// lane k's answer. the arrays need room for SIMD_MAX_WIDTH ids, spare lanes are overwritten
+template <typename Scalar, typename Index>
+unsigned in_circle_batch(
+    const simd_level level,
+    point_view<Scalar> const& points,
+    const std::size_t count,
+    Index* a,
+    Index* b,
+    Index* c,
+    Index* p
+) {
+    const std::size_t width = simd_width(level);
+    for (std::size_t k = count; k < width; k++) {
+        a[k] = a[0];
+        b[k] = b[0];
+        c[k] = c[0];
+        p[k] = p[0];
+    }
+    unsigned result = 0;
+    switch (level) {
+#ifdef DELAUNATOR_X86_SIMD
+        case simd_level::avx512: result = in_circle_avx512(points, a, b, c, p); break;
+        case simd_level::avx2: result = in_circle_avx2(points, a, b, c, p); break;
+        case simd_level::sse2: result = in_circle_lanes<sse2_lanes>(points, a, b, c, p); break;
+#endif
+        default:
+            for (std::size_t k = 0; k < count; k++) {
+                if (in_circle(
+                        points.x(a[k]), points.y(a[k]),
+                        points.x(b[k]), points.y(b[k]),
+                        points.x(c[k]), points.y(c[k]),
+                        points.x(p[k]), points.y(p[k]))) {
+                    result |= 1u << k;
+                }
+            }
+            break;
+    }
+    return result & ((1u << count) - 1);
+}
+
+// orient(p, q[k], r[k]) for count <= simd_width(level) edges at once, as in_circle_batch
+template <typename Scalar, typename Index>
+unsigned orient_batch(
+    const simd_level level,
+    point_view<Scalar> const& points,
+    const double px,
+    const double py,
+    const std::size_t count,
+    Index* q,
+    Index* r
+) {
+    const std::size_t width = simd_width(level);
+    for (std::size_t k = count; k < width; k++) {
+        q[k] = q[0];
+        r[k] = r[0];
+    }
+    unsigned result = 0;
+    switch (level) {
+#ifdef DELAUNATOR_X86_SIMD
+        case simd_level::avx512: result = orient_avx512(points, px, py, q, r); break;
+        case simd_level::avx2: result = orient_avx2(points, px, py, q, r); break;
+        case simd_level::sse2: result = orient_lanes<sse2_lanes>(points, px, py, q, r); break;
+#endif
+        default:
+            for (std::size_t k = 0; k < count; k++) {
+                if (orient(px, py, points.x(q[k]), points.y(q[k]), points.x(r[k]), points.y(r[k]))) {
+                    result |= 1u << k;
+                }
+            }
+            break;
+    }
+    return result & ((1u << count) - 1);
+}
+
+worker_pool::~worker_pool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& thread : m_threads) thread.join();
+}
+
+void worker_pool::run(std::size_t count, const std::function<void(std::size_t)>& task) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // a new worker starts out waiting for the run after the current generation
+        while (m_threads.size() + 1 < count) {
+            m_threads.emplace_back(&worker_pool::work, this, m_threads.size() + 1, m_generation);
+        }
+        m_task = &task;
+        m_count = count;
+        m_pending = count - 1;
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    task(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_pending == 0; });
+    m_task = nullptr;
+}
+
+void worker_pool::work(std::size_t index, std::size_t generation) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_wake.wait(lock, [&] { return m_stop || m_generation != generation; });
+        if (m_stop) return;
+        generation = m_generation;
+        if (index >= m_count) continue;
+
+        const std::function<void(std::size_t)>& task = *m_task;
+        lock.unlock();
+        task(index);
+        lock.lock();
+        if (--m_pending == 0) m_done.notify_one();
+    }
+}
+
+template <typename Scalar, typename Index>
+BasicDelaunator<Scalar, Index>::BasicDelaunator()
+    : triangles(),
       halfedges(),
       hull_prev(),
       hull_next(),
       hull_tri(),
       hull_start(),
+      m_points(),
+      m_ids(),
+      m_ids_tmp(),
+      m_keys(),
+      m_keys_tmp(),
+      m_ids_sorted(false),
+      m_seed(),
+      m_resort_skip(),
       m_hash(),
       m_center_x(),
       m_center_y(),
       m_hash_size(),
-      m_edge_stack() {
-    std::size_t n = coords.size() >> 1;
+      m_edge_stack(),
+      m_flips(),
+      m_hull_fixups(),
+      m_parts(),
+      m_part_coords(),
+      m_part_bounds(),
+      m_part_offsets(),
+      m_part_extremes(),
+      m_part_failed(),
+      m_workers(),
+      m_seam_stack(),
+      m_tangled(),
+      m_stuck(),
+      m_link_points(),
+      m_link_outer(),
+      m_link_slots(),
+      m_link_order(),
+      m_ears() {}
+
+template <typename Scalar, typename Index>
+BasicDelaunator<Scalar, Index>::BasicDelaunator(point_view<Scalar> in_points)
+    : BasicDelaunator() {
+    update(in_points);
+}
+
+template <typename Scalar, typename Index>
+void BasicDelaunator<Scalar, Index>::update(point_view<Scalar> in_points, std::size_t threads) {
+    m_points = in_points;
+    if (threads > 1 && build_parallel(threads)) return;
+    sweep();
+}
+
+template <typename Scalar, typename Index>
+void BasicDelaunator<Scalar, Index>::sweep() {
+    point_view<Scalar> const& points = m_points;
+    std::size_t n = points.size();
 
     double max_x = std::numeric_limits<double>::min();
     double max_y = std::numeric_limits<double>::min();
     double min_x = std::numeric_limits<double>::max();
     double min_y = std::numeric_limits<double>::max();
-    std::vector<std::size_t> ids;
-    ids.reserve(n);
+    std::vector<Index>& ids = m_ids;
 
-    for (std::size_t i = 0; i < n; i++) {
-        const double x = coords[2 * i];
-        const double y = coords[2 * i + 1];
+    for (Index i = 0; i < n; i++) {
+        const double x = points.x(i);
+        const double y = points.y(i);
 
         if (x < min_x) min_x = x;
         if (y < min_y) min_y = y;
         if (x > max_x) max_x = x;
         if (y > max_y) max_y = y;
-
-        ids.push_back(i);
     }
     const double cx = (min_x + max_x) / 2;
     const double cy = (min_y + max_y) / 2;
     double min_dist = std::numeric_limits<double>::max();
 
-    std::size_t i0 = INVALID_INDEX;
-    std::size_t i1 = INVALID_INDEX;
-    std::size_t i2 = INVALID_INDEX;
+    Index i0 = INVALID_INDEX;
+    Index i1 = INVALID_INDEX;
+    Index i2 = INVALID_INDEX;
 
     // pick a seed point close to the centroid
-    for (std::size_t i = 0; i < n; i++) {
-        const double d = dist(cx, cy, coords[2 * i], coords[2 * i + 1]);
-        if (d < min_dist) {
-            i0 = i;
-            min_dist = d;
-        }
-    }
+    i0 = seed_scan<Scalar, Index>(points, seed_metric::center_dist, cx, cy, 0.0, 0.0, min_dist);
 
-    const double i0x = coords[2 * i0];
-    const double i0y = coords[2 * i0 + 1];
+    const double i0x = points.x(i0);
+    const double i0y = points.y(i0);
 
     min_dist = std::numeric_limits<double>::max();
 
     // find the point closest to the seed
-    for (std::size_t i = 0; i < n; i++) {
-        if (i == i0) continue;
-        const double d = dist(i0x, i0y, coords[2 * i], coords[2 * i + 1]);
-        if (d < min_dist && d > 0.0f) {
-            i1 = i;
-            min_dist = d;
-        }
-    }
+    i1 = seed_scan<Scalar, Index>(points, seed_metric::seed_dist, i0x, i0y, 0.0, 0.0, min_dist);
 
-    double i1x = coords[2 * i1];
-    double i1y = coords[2 * i1 + 1];
+    double i1x = points.x(i1);
+    double i1y = points.y(i1);
 
     double min_radius = std::numeric_limits<double>::max();
 
     // find the third point which forms the smallest circumcircle with the first two
-    for (std::size_t i = 0; i < n; i++) {
-        if (i == i0 || i == i1) continue;
-
-        const double r = circumradius(
-            i0x, i0y, i1x, i1y, coords[2 * i], coords[2 * i + 1]);
-
-        if (r < min_radius) {
-            i2 = i;
-            min_radius = r;
-        }
-    }
+    i2 = seed_scan<Scalar, Index>(points, seed_metric::circumradius, i0x, i0y, i1x, i1y, min_radius);
 
     if (!(min_radius < std::numeric_limits<double>::max())) {
         throw std::runtime_error("not triangulation");
     }
 
-    double i2x = coords[2 * i2];
-    double i2y = coords[2 * i2 + 1];
+    double i2x = points.x(i2);
+    double i2y = points.y(i2);
 
     if (orient(i0x, i0y, i1x, i1y, i2x, i2y)) {
         std::swap(i1, i2);
@@ -241,8 +779,33 @@ Delaunator::Delaunator(std::vector<double> const& in_coords)
 
     std::tie(m_center_x, m_center_y) = circumcenter(i0x, i0y, i1x, i1y, i2x, i2y);
 
-    // sort the points by distance from the seed triangle circumcenter
-    std::sort(ids.begin(), ids.end(), compare{ coords, m_center_x, m_center_y });
+    // sort the points by distance from the seed triangle circumcenter; with the same
+    // seed triangle as the last sweep, the last order is a nearly sorted starting point
+    const bool coherent =
+        m_ids_sorted && ids.size() == n && n >= RADIX_SORT_MIN_POINTS &&
+        m_seed[0] == i0 && m_seed[1] == i1 && m_seed[2] == i2;
+    m_seed = { i0, i1, i2 };
+
+    bool resorted = false;
+    if (coherent && m_resort_skip > 0) {
+        m_resort_skip--;
+    } else if (coherent) {
+        resorted = resort_by_distance();
+        // the points move too fast for the last order to help; don't retry every sweep
+        if (!resorted) m_resort_skip = COHERENT_SORT_BACKOFF;
+    }
+
+    if (!resorted) {
+        ids.resize(n);
+        for (Index i = 0; i < n; i++) ids[i] = i;
+
+        if (n < RADIX_SORT_MIN_POINTS) {
+            std::sort(ids.begin(), ids.end(), compare<Scalar>{ points, m_center_x, m_center_y });
+        } else {
+            sort_by_distance();
+        }
+    }
+    m_ids_sorted = true;
 
     // initialize a hash table for storing edges of the advancing convex hull
     m_hash_size = static_cast<std::size_t>(std::llround(std::ceil(std::sqrt(n))));
@@ -271,15 +834,24 @@ Delaunator::Delaunator(std::vector<double> const& in_coords)
     m_hash[hash_key(i2x, i2y)] = i2;
 
     std::size_t max_triangles = n < 3 ? 1 : 2 * n - 5;
+    if (max_triangles * 3 >= static_cast<std::size_t>(INVALID_INDEX)) {
+        throw std::runtime_error("too many points for the index type");
+    }
+    triangles.clear();
+    halfedges.clear();
     triangles.reserve(max_triangles * 3);
     halfedges.reserve(max_triangles * 3);
     add_triangle(i0, i1, i2, INVALID_INDEX, INVALID_INDEX, INVALID_INDEX);
+    const simd_level level = get_simd_level();
+    const std::size_t walk_width = simd_width(level);
+    std::array<Index, SIMD_MAX_WIDTH> walk_from;
+    std::array<Index, SIMD_MAX_WIDTH> walk_to;
     double xp = std::numeric_limits<double>::quiet_NaN();
     double yp = std::numeric_limits<double>::quiet_NaN();
     for (std::size_t k = 0; k < n; k++) {
-        const std::size_t i = ids[k];
-        const double x = coords[2 * i];
-        const double y = coords[2 * i + 1];
+        const Index i = ids[k];
+        const double x = points.x(i);
+        const double y = points.y(i);
 
         // skip near-duplicate points
         if (k > 0 && check_pts_equal(x, y, xp, yp)) continue;
@@ -293,7 +865,7 @@ Delaunator::Delaunator(std::vector<double> const& in_coords)
             check_pts_equal(x, y, i2x, i2y)) continue;
 
         // find a visible edge on the convex hull using edge hash
-        std::size_t start = 0;
+        Index start = 0;
 
         size_t key = hash_key(x, y);
         for (size_t j = 0; j < m_hash_size; j++) {
@@ -302,21 +874,36 @@ Delaunator::Delaunator(std::vector<double> const& in_coords)
         }
 
         start = hull_prev[start];
-        size_t e = start;
-        size_t q;
-
-        while (q = hull_next[e], !orient(x, y, coords[2 * e], coords[2 * e + 1], coords[2 * q], coords[2 * q + 1])) {
-            e = q;
-            if (e == start) {
+        Index e = start;
+        Index q;
+
+        // walk forward to the first edge the point sees, testing a batch of edges at a time
+        while (true) {
+            Index node = e;
+            std::size_t count = 0;
+            do {
+                walk_from[count] = node;
+                node = hull_next[node];
+                walk_to[count] = node;
+                count++;
+            } while (count < walk_width && node != start);
+
+            const unsigned visible = orient_batch(level, points, x, y, count, walk_from.data(), walk_to.data());
+            if (visible != 0) {
+                e = walk_from[std::countr_zero(visible)];
+                break;
+            }
+            if (node == start) {
                 e = INVALID_INDEX;
                 break;
             }
+            e = node;
         }
 
         if (e == INVALID_INDEX) continue; // likely a near-duplicate point; skip it
 
         // add the first triangle from the point
-        std::size_t t = add_triangle(
+        Index t = add_triangle(
             e,
             i,
             hull_next[e],
@@ -329,10 +916,10 @@ Delaunator::Delaunator(std::vector<double> const& in_coords)
         hull_size++;
 
         // walk forward through the hull, adding more triangles and flipping recursively
-        std::size_t next = hull_next[e];
+        Index next = hull_next[e];
         while (
             q = hull_next[next],
-            orient(x, y, coords[2 * next], coords[2 * next + 1], coords[2 * q], coords[2 * q + 1])) {
+            orient(x, y, points.x(next), points.y(next), points.x(q), points.y(q))) {
             t = add_triangle(next, i, q, hull_tri[i], INVALID_INDEX, hull_tri[next]);
             hull_tri[i] = legalize(t + 2);
             hull_next[next] = next; // mark as removed
@@ -344,7 +931,7 @@ Delaunator::Delaunator(std::vector<double> const& in_coords)
         if (e == start) {
             while (
                 q = hull_prev[e],
-                orient(x, y, coords[2 * q], coords[2 * q + 1], coords[2 * e], coords[2 * e + 1])) {
+                orient(x, y, points.x(q), points.y(q), points.x(e), points.y(e))) {
                 t = add_triangle(q, i, e, INVALID_INDEX, hull_tri[e], hull_tri[q]);
                 legalize(t + 2);
                 hull_tri[q] = t;
@@ -362,28 +949,932 @@ Delaunator::Delaunator(std::vector<double> const& in_coords)
         hull_next[i] = next;
 
         m_hash[hash_key(x, y)] = i;
-        m_hash[hash_key(coords[2 * e], coords[2 * e + 1])] = e;
+        m_hash[hash_key(points.x(e), points.y(e))] = e;
     }
 }
 
-double Delaunator::get_hull_area() {
+template <typename Scalar, typename Index>
+void BasicDelaunator<Scalar, Index>::sort_by_distance() {
+    point_view<Scalar> const& points = m_points;
+    const std::size_t n = m_ids.size();
+
+    // the keys are computed once into a flat array instead of twice per comparison;
+    // non-negative doubles order the same way as their bit patterns
+    m_keys.resize(n);
+    m_keys_tmp.resize(n);
+    m_ids_tmp.resize(n);
+    for (std::size_t k = 0; k < n; k++) {
+        const Index i = m_ids[k];
+        m_keys[k] = std::bit_cast<std::uint64_t>(dist(points.x(i), points.y(i), m_center_x, m_center_y));
+    }
+
+    // stable LSD radix sort; equal distances keep the index order
+    constexpr std::size_t buckets = std::size_t{1} << RADIX_SORT_BITS;
+    constexpr std::uint64_t mask = buckets - 1;
+    std::array<std::size_t, buckets> counts;
+
+    for (unsigned shift = 0; shift < 64; shift += RADIX_SORT_BITS) {
+        counts.fill(0);
+        for (std::size_t k = 0; k < n; k++) {
+            counts[(m_keys[k] >> shift) & mask]++;
+        }
+
+        // skip digits every key shares, like the sign and high exponent bits
+        if (counts[(m_keys[0] >> shift) & mask] == n) continue;
+
+        std::size_t offset = 0;
+        for (std::size_t& count : counts) {
+            const std::size_t c = count;
+            count = offset;
+            offset += c;
+        }
+
+        for (std::size_t k = 0; k < n; k++) {
+            const std::size_t to = counts[(m_keys[k] >> shift) & mask]++;
+            m_keys_tmp[to] = m_keys[k];
+            m_ids_tmp[to] = m_ids[k];
+        }
+        m_keys.swap(m_keys_tmp);
+        m_ids.swap(m_ids_tmp);
+    }
+}
+
+template <typename Scalar, typename Index>
+bool BasicDelaunator<Scalar, Index>::resort_by_distance() {
+    point_view<Scalar> const& points = m_points;
+    const std::size_t n = m_ids.size();
+
+    m_keys.resize(n);
+    for (std::size_t k = 0; k < n; k++) {
+        const Index i = m_ids[k];
+        m_keys[k] = std::bit_cast<std::uint64_t>(dist(points.x(i), points.y(i), m_center_x, m_center_y));
+    }
+
+    // insertion sort, ties by index like the stable radix sort; gives up once the
+    // order has drifted too far for it to beat a full sort
+    std::size_t budget = n * COHERENT_SORT_MAX_SHIFTS;
+    for (std::size_t k = 1; k < n; k++) {
+        const std::uint64_t key = m_keys[k];
+        const Index id = m_ids[k];
+        std::size_t j = k;
+        while (j > 0 && (m_keys[j - 1] > key || (m_keys[j - 1] == key && m_ids[j - 1] > id))) {
+            if (budget-- == 0) return false;
+            m_keys[j] = m_keys[j - 1];
+            m_ids[j] = m_ids[j - 1];
+            j--;
+        }
+        m_keys[j] = key;
+        m_ids[j] = id;
+    }
+    return true;
+}
+
+template <typename Scalar, typename Index>
+bool BasicDelaunator<Scalar, Index>::repair(point_view<Scalar> in_points, std::size_t threads) {
+    const std::size_t n = in_points.size();
+
+    if (triangles.empty() || hull_next.size() != n) {
+        update(in_points, threads);
+        return false;
+    }
+
+    m_points = in_points;
+    point_view<Scalar> const& points = m_points;
+
+    std::size_t hull_size = 0;
+    Index e = hull_start;
+    do {
+        hull_size++;
+        e = hull_next[e];
+    } while (e != hull_start && hull_size <= n);
+
+    // points skipped as near-duplicates by the sweep are not in the mesh and can't be flipped back in
+    if (triangles.size() != 3 * (2 * n - 2 - hull_size)) {
+        update(in_points, threads);
+        return false;
+    }
+
+    const std::size_t max_flips = std::max(n / KINETIC_FLIP_DIVISOR, KINETIC_MIN_FLIPS);
+    const std::size_t start_flips = m_flips;
+    std::size_t hull_ops = 0;
+
+    // interior points that crossed a hull edge become hull vertices: drop the inverted hull triangle
+    for (Index t = 0; t < triangles.size();) {
+        if (is_inverted(t) && pop_out(t)) {
+            hull_size++;
+            if (++hull_ops > max_flips) {
+                update(in_points, threads);
+                return false;
+            }
+            continue; // the last triangle was moved into slot t
+        }
+        t += 3;
+    }
+
+    // hull vertices that moved inward leave a reflex corner; close it with an ear triangle
+    e = hull_start;
+    for (std::size_t steps = 0; steps < hull_size;) {
+        const Index q = hull_next[e];
+        const Index r = hull_next[q];
+        if (!orient(points.x(r), points.y(r), points.x(e), points.y(e), points.x(q), points.y(q))) {
+            e = q;
+            steps++;
+            continue;
+        }
+        if (hull_size <= 3 || ++hull_ops > max_flips) {
+            update(in_points, threads);
+            return false;
+        }
+
+        hull_tri[e] = add_triangle(e, r, q, INVALID_INDEX, hull_tri[q], hull_tri[e]);
+        hull_next[e] = r;
+        hull_prev[r] = e;
+        hull_next[q] = q; // mark as removed
+        if (hull_start == q) hull_start = e;
+        hull_size--;
+
+        // the corner at e changed too; step back to recheck it
+        e = hull_prev[e];
+        steps = 0;
+    }
+
+    // untangle triangles whose vertices crossed an edge since the last frame. one scan
+    // finds them; a flip or reinsertion only disturbs the triangles it rewrites, which
+    // go back on the work list instead of the whole mesh being scanned again
+    m_tangled.clear();
+    m_stuck.clear();
+    for (Index t = 0; t < triangles.size(); t += 3) {
+        if (is_inverted(t)) m_tangled.push_back(t);
+    }
+    while (true) {
+        while (!m_tangled.empty()) {
+            const Index t = m_tangled.back();
+            m_tangled.pop_back();
+            if (!is_inverted(t)) continue;
+
+            if (!untangle(t)) m_stuck.push_back(t);
+            if (m_flips - start_flips > max_flips) {
+                update(in_points, threads);
+                return false;
+            }
+        }
+
+        // folds left over once flips run dry need a point moved. move one, then go back
+        // to flipping: that often frees the other folds, or makes their points movable
+        Index start = INVALID_INDEX;
+        for (std::size_t i = m_stuck.size(); i-- > 0 && start == INVALID_INDEX;) {
+            const Index t = m_stuck[i];
+            if (is_inverted(t)) {
+                for (Index e = t; e < t + 3 && start == INVALID_INDEX; e++) {
+                    if (clip_link(e)) start = e;
+                }
+                if (start == INVALID_INDEX) continue;
+            }
+            m_stuck[i] = m_stuck.back();
+            m_stuck.pop_back();
+        }
+        if (start == INVALID_INDEX) {
+            if (m_stuck.empty()) break;
+            update(in_points, threads);
+            return false;
+        }
+        if (!reinsert(start) || m_flips - start_flips > max_flips) {
+            update(in_points, threads);
+            return false;
+        }
+    }
+
+    // restore the Delaunay condition; passes repeat until no edge flips. in_circle runs
+    // on a batch of edges at once and only the first illegal one is legalized before
+    // the next batch, which is what legalizing every edge in turn amounts to
+    const simd_level level = get_simd_level();
+    const std::size_t width = simd_width(level);
+    std::array<Index, SIMD_MAX_WIDTH> edges;
+    std::array<Index, SIMD_MAX_WIDTH> p0;
+    std::array<Index, SIMD_MAX_WIDTH> pr;
+    std::array<Index, SIMD_MAX_WIDTH> pl;
+    std::array<Index, SIMD_MAX_WIDTH> p1;
+    std::size_t pass_flips;
+    do {
+        pass_flips = m_flips;
+        Index a = 0;
+        while (a < halfedges.size()) {
+            std::size_t count = 0;
+            for (; a < halfedges.size() && count < width; a++) {
+                const Index b = halfedges[a];
+                if (b == INVALID_INDEX || b < a) continue;
+                const Index a0 = 3 * (a / 3);
+                edges[count] = a;
+                p0[count] = triangles[a0 + (a + 2) % 3];
+                pr[count] = triangles[a];
+                pl[count] = triangles[a0 + (a + 1) % 3];
+                p1[count] = triangles[3 * (b / 3) + (b + 2) % 3];
+                count++;
+            }
+            if (count == 0) break;
+
+            const unsigned illegal = in_circle_batch(
+                level, m_points, count, p0.data(), pr.data(), pl.data(), p1.data());
+            if (illegal != 0) {
+                const Index e = edges[std::countr_zero(illegal)];
+                legalize(e);
+                a = e + 1;
+            }
+        }
+        if (m_flips - start_flips > max_flips) {
+            update(in_points, threads);
+            return false;
+        }
+    } while (m_flips != pass_flips);
+
+    // flips can move hull edges to other halfedge slots
+    if (m_flips != start_flips) {
+        for (Index a = 0; a < halfedges.size(); a++) {
+            if (halfedges[a] == INVALID_INDEX) {
+                hull_tri[triangles[a]] = a;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename Scalar, typename Index>
+bool BasicDelaunator<Scalar, Index>::is_inverted(Index t) const {
+    point_view<Scalar> const& points = m_points;
+    const Index p0 = triangles[t];
+    const Index p1 = triangles[t + 1];
+    const Index p2 = triangles[t + 2];
+    return orient(
+        points.x(p0), points.y(p0),
+        points.x(p1), points.y(p1),
+        points.x(p2), points.y(p2));
+}
+
+template <typename Scalar, typename Index>
+bool BasicDelaunator<Scalar, Index>::untangle(Index t) {
+    point_view<Scalar> const& points = m_points;
+
+    // flip the first edge of the triangle whose flipped pair has a valid orientation
+    for (Index a = t; a < t + 3; a++) {
+        const Index b = halfedges[a];
+        if (b == INVALID_INDEX) continue;
+
+        const Index a0 = 3 * (a / 3);
+        const Index b0 = 3 * (b / 3);
+        const Index p0 = triangles[a0 + (a + 2) % 3];
+        const Index pr = triangles[a];
+        const Index pl = triangles[a0 + (a + 1) % 3];
+        const Index p1 = triangles[b0 + (b + 2) % 3];
+
+        // a fold can leave both sides of an edge with the same apex; flipping would collapse it
+        if (p0 == p1) continue;
+
+        if (orient(points.x(p1), points.y(p1), points.x(pl), points.y(pl), points.x(p0), points.y(p0)) ||
+            orient(points.x(p0), points.y(p0), points.x(pr), points.y(pr), points.x(p1), points.y(p1))) {
+            continue;
+        }
+
+        flip(a);
+        m_tangled.push_back(a0);
+        m_tangled.push_back(b0);
+        return true;
+    }
+    return false;
+}
+
+template <typename Scalar, typename Index>
+bool BasicDelaunator<Scalar, Index>::reinsert(Index start) {
+    // clip_link(start) has just measured the hole the point leaves behind
+    const Index p = triangles[start];
+    const std::size_t degree = m_link_points.size();
+
+    // a point folded between just two triangles leaves no hole: close the seam
+    if (degree == 2) {
+        const Index o0 = m_link_outer[0];
+        const Index o1 = m_link_outer[1];
+        if (o0 == INVALID_INDEX && o1 == INVALID_INDEX) return false;
+        if (o0 == INVALID_INDEX || o1 == INVALID_INDEX) {
+            const Index o = o0 == INVALID_INDEX ? o1 : o0;
+            halfedges[o] = INVALID_INDEX;
+            hull_tri[triangles[o]] = o;
+        } else {
+            link(o0, o1);
+        }
+    }
+
+    // fill the hole with the ears, reusing the freed slots; m_link_outer[i] tracks the
+    // halfedge across the hole's current edge from corner i to the next one
+    std::size_t slot = 0;
+    for (std::size_t k = 0; k < m_ears.size(); k += 3) {
+        const Index s = m_link_slots[slot++];
+        const std::size_t ear[3] = { m_ears[k], m_ears[k + 1], m_ears[k + 2] };
+        const bool last = k + 3 == m_ears.size();
+        for (Index j = 0; j < 3; j++) {
+            triangles[s + j] = m_link_points[ear[j]];
+        }
+        for (Index j = 0; j < (last ? 3u : 2u); j++) {
+            link(s + j, m_link_outer[ear[j]]);
+            if (halfedges[s + j] == INVALID_INDEX) hull_tri[triangles[s + j]] = s + j;
+        }
+        if (!last) m_link_outer[ear[0]] = s + 2;
+        m_tangled.push_back(s);
+    }
+    m_flips += degree;
+
+    // split the triangle the point now lies in, using the two slots left over
+    const Index from = degree > 2 ? m_link_slots[0]
+                     : 3 * ((m_link_outer[0] == INVALID_INDEX ? m_link_outer[1] : m_link_outer[0]) / 3);
+    bool outside = false;
+    const Index a0 = locate(from, p, outside);
+    if (a0 == INVALID_INDEX) return false;
+
+    const Index b0 = m_link_slots[degree - 2];
+    const Index c0 = m_link_slots[degree - 1];
+    if (outside) return attach(a0, p, b0, c0);
+    const Index pa = triangles[a0];
+    const Index pb = triangles[a0 + 1];
+    const Index pc = triangles[a0 + 2];
+    const Index hb = halfedges[a0 + 1];
+    const Index hc = halfedges[a0 + 2];
+
+    triangles[a0 + 2] = p;
+    triangles[b0] = pb;
+    triangles[b0 + 1] = pc;
+    triangles[b0 + 2] = p;
+    triangles[c0] = pc;
+    triangles[c0 + 1] = pa;
+    triangles[c0 + 2] = p;
+
+    link(b0, hb);
+    link(c0, hc);
+    link(a0 + 1, b0 + 2);
+    link(b0 + 1, c0 + 2);
+    link(c0 + 1, a0 + 2);
+    if (hb == INVALID_INDEX) hull_tri[pb] = b0;
+    if (hc == INVALID_INDEX) hull_tri[pc] = c0;
+
+    m_tangled.push_back(a0);
+    m_tangled.push_back(b0);
+    m_tangled.push_back(c0);
+    return true;
+}
+
+template <typename Scalar, typename Index>
+bool BasicDelaunator<Scalar, Index>::attach(Index a, Index p, Index t, Index spare) {
+    point_view<Scalar> const& points = m_points;
+
+    // p moved out across the hull edge a: cap the edge with the triangle (p1, p0, p) in slot t
+    const Index p0 = triangles[a];
+    const Index p1 = triangles[3 * (a / 3) + (a + 1) % 3];
+
+    triangles[t] = p1;
+    triangles[t + 1] = p0;
+    triangles[t + 2] = p;
+    link(t, a);
+    halfedges[t + 1] = INVALID_INDEX;
+    halfedges[t + 2] = INVALID_INDEX;
+
+    hull_next[p0] = p;
+    hull_prev[p] = p0;
+    hull_next[p] = p1;
+    hull_prev[p1] = p;
+    hull_tri[p0] = t + 1;
+    hull_tri[p] = t + 2;
+    m_tangled.push_back(t);
+
+    // one more hull point means one triangle fewer; the work list follows the
+    // triangle remove_triangle() moves into the spare slot
+    const Index last = static_cast<Index>(triangles.size() - 3);
+    for (Index k = spare; k < spare + 3; k++) halfedges[k] = INVALID_INDEX;
+    remove_triangle(spare);
+    for (Index& queued : m_tangled) {
+        if (queued == last) queued = spare;
+    }
+    for (Index& queued : m_stuck) {
+        if (queued == last) queued = spare;
+    }
+
+    // p can also stick out past the corners at either end of the edge; fill the
+    // notches that leaves with ears, as repair() does for points that moved inward
+    Index e = hull_prev[p0];
+    for (std::size_t convex = 0, ears = 0; convex < 3;) {
+        const Index q = hull_next[e];
+        const Index r = hull_next[q];
+        if (!orient(points.x(r), points.y(r), points.x(e), points.y(e), points.x(q), points.y(q))) {
+            e = q;
+            convex++;
+            continue;
+        }
+        if (r == e || ++ears > KINETIC_WALK_STEPS) return false;
+
+        hull_tri[e] = add_triangle(e, r, q, INVALID_INDEX, hull_tri[q], hull_tri[e]);
+        m_tangled.push_back(hull_tri[e]);
+        hull_next[e] = r;
+        hull_prev[r] = e;
+        hull_next[q] = q; // mark as removed
+        if (hull_start == q) hull_start = e;
+
+        e = hull_prev[e];
+        convex = 0;
+    }
+    return true;
+}
+
+template <typename Scalar, typename Index>
+bool BasicDelaunator<Scalar, Index>::clip_link(Index e) {
+    point_view<Scalar> const& points = m_points;
+
+    // walk around the point the halfedge e leaves from, collecting the polygon of its
+    // neighbours; a point on the hull has an open fan and is left alone
+    m_link_points.clear();
+    m_link_outer.clear();
+    m_link_slots.clear();
+    Index a = e;
+    do {
+        const Index t = 3 * (a / 3);
+        const Index next = t + (a + 1) % 3;
+        m_link_points.push_back(triangles[next]);
+        m_link_outer.push_back(halfedges[next]);
+        m_link_slots.push_back(t);
+
+        a = halfedges[t + (a + 2) % 3];
+        if (a == INVALID_INDEX || m_link_points.size() > KINETIC_MAX_DEGREE) return false;
+    } while (a != e);
+
+    const std::size_t degree = m_link_points.size();
+    const auto x = [&](std::size_t i) { return static_cast<double>(points.x(m_link_points[i])); };
+    const auto y = [&](std::size_t i) { return static_cast<double>(points.y(m_link_points[i])); };
+    // positive for corners in the winding of the mesh's triangles, as in orient()
+    const auto cross = [&](std::size_t i, std::size_t j, std::size_t k) {
+        return (y(j) - y(i)) * (x(k) - x(j)) - (x(j) - x(i)) * (y(k) - y(j));
+    };
+
+    // the polygon must be simple: no repeated corner, no two edges touching
+    for (std::size_t i = 0; i < degree; i++) {
+        for (std::size_t j = i + 1; j < degree; j++) {
+            if (m_link_points[i] == m_link_points[j]) return false;
+
+            const std::size_t i1 = (i + 1) % degree;
+            const std::size_t j1 = (j + 1) % degree;
+            if (j == i1 || i == j1) continue;
+            if (cross(i, i1, j) * cross(i, i1, j1) <= 0.0 && cross(j, j1, i) * cross(j, j1, i1) <= 0.0) {
+                return false;
+            }
+        }
+    }
+
+    // ear clipping: cut off corners that turn the right way and hold no other corner
+    m_ears.clear();
+    if (degree == 2) return true;
+    m_link_order.resize(degree);
+    for (std::size_t i = 0; i < degree; i++) m_link_order[i] = i;
+    while (m_link_order.size() > 3) {
+        const std::size_t size = m_link_order.size();
+        bool clipped = false;
+        for (std::size_t i = 0; i < size && !clipped; i++) {
+            const std::size_t pa = m_link_order[(i + size - 1) % size];
+            const std::size_t pb = m_link_order[i];
+            const std::size_t pc = m_link_order[(i + 1) % size];
+            if (!(cross(pa, pb, pc) > 0.0)) continue;
+
+            bool empty = true;
+            for (const std::size_t q : m_link_order) {
+                if (q == pa || q == pb || q == pc) continue;
+                if (cross(pa, pb, q) >= 0.0 && cross(pb, pc, q) >= 0.0 && cross(pc, pa, q) >= 0.0) {
+                    empty = false;
+                    break;
+                }
+            }
+            if (!empty) continue;
+
+            m_ears.insert(m_ears.end(), { pa, pb, pc });
+            m_link_order.erase(m_link_order.begin() + static_cast<std::ptrdiff_t>(i));
+            clipped = true;
+        }
+        if (!clipped) return false;
+    }
+    if (!(cross(m_link_order[0], m_link_order[1], m_link_order[2]) > 0.0)) return false;
+    m_ears.insert(m_ears.end(), m_link_order.begin(), m_link_order.end());
+    return true;
+}
+
+template <typename Scalar, typename Index>
+Index BasicDelaunator<Scalar, Index>::locate(Index t, Index p, bool& outside) const {
+    point_view<Scalar> const& points = m_points;
+    const double x = points.x(p);
+    const double y = points.y(p);
+
+    const auto beyond = [&](Index t, Index a) {
+        const Index p0 = triangles[a];
+        const Index p1 = triangles[t + (a + 1) % 3];
+        return orient(points.x(p0), points.y(p0), points.x(p1), points.y(p1), x, y);
+    };
+
+    // visibility walk: step across any edge the point lies strictly beyond
+    outside = false;
+    for (std::size_t steps = 0; steps < KINETIC_WALK_STEPS; steps++) {
+        Index across = INVALID_INDEX;
+        for (Index a = t; a < t + 3; a++) {
+            if (beyond(t, a)) {
+                across = a;
+                break;
+            }
+        }
+        if (across == INVALID_INDEX && !is_inverted(t)) return t;
+        if (across == INVALID_INDEX) break;
+
+        // the point left the hull through this hull edge
+        const Index b = halfedges[across];
+        if (b == INVALID_INDEX) {
+            outside = true;
+            return across;
+        }
+        t = 3 * (b / 3);
+    }
+
+    // folds still waiting to be untangled can trap the walk; a scan is still far
+    // cheaper than the rebuild it saves. the slots still holding p are unlinked
+    for (t = 0; t < triangles.size(); t += 3) {
+        if (triangles[t] == p || triangles[t + 1] == p || triangles[t + 2] == p) continue;
+        if (!is_inverted(t) && !beyond(t, t) && !beyond(t, t + 1) && !beyond(t, t + 2)) return t;
+    }
+    return INVALID_INDEX;
+}
+
+template <typename Scalar, typename Index>
+void BasicDelaunator<Scalar, Index>::flip(Index a) {
+    // same rotation as in legalize, but also keeps hull_tri pointing at hull edges that move
+    const Index b = halfedges[a];
+    const Index a0 = 3 * (a / 3);
+    const Index b0 = 3 * (b / 3);
+    const Index ar = a0 + (a + 2) % 3;
+    const Index bl = b0 + (b + 2) % 3;
+
+    const Index p0 = triangles[ar];
+    const Index p1 = triangles[bl];
+
+    triangles[a] = p1;
+    triangles[b] = p0;
+
+    link(a, halfedges[bl]);
+    link(b, halfedges[ar]);
+    link(ar, bl);
+    m_flips++;
+
+    if (halfedges[a] == INVALID_INDEX) hull_tri[triangles[a]] = a;
+    if (halfedges[b] == INVALID_INDEX) hull_tri[triangles[b]] = b;
+}
+
+template <typename Scalar, typename Index>
+bool BasicDelaunator<Scalar, Index>::build_parallel(std::size_t threads) {
+    point_view<Scalar> const& points = m_points;
+    const std::size_t n = points.size();
+    const std::size_t parts = std::min(threads, n / PARALLEL_MIN_POINTS);
+    if (parts < 2) return false;
+
+    // split the points into vertical strips of equal size
+    const auto by_x = [&points](Index i, Index j) {
+        return points.x(i) < points.x(j) ||
+               (points.x(i) == points.x(j) && points.y(i) < points.y(j));
+    };
+
+    m_ids_sorted = false;
+    m_ids.resize(n);
+    for (Index i = 0; i < n; i++) m_ids[i] = i;
+
+    m_part_bounds.resize(parts + 1);
+    for (std::size_t p = 0; p <= parts; p++) m_part_bounds[p] = n * p / parts;
+
+    const auto split = [&](auto& self, std::size_t lo, std::size_t hi) -> void {
+        if (hi - lo < 2) return;
+        const std::size_t mid = (lo + hi) / 2;
+        std::nth_element(
+            m_ids.begin() + static_cast<std::ptrdiff_t>(m_part_bounds[lo]),
+            m_ids.begin() + static_cast<std::ptrdiff_t>(m_part_bounds[mid]),
+            m_ids.begin() + static_cast<std::ptrdiff_t>(m_part_bounds[hi]),
+            by_x);
+        self(self, lo, mid);
+        self(self, mid, hi);
+    };
+    split(split, 0, parts);
+
+    // strips that share an x coordinate have touching hulls the zipper can't handle.
+    // each strip's leftmost point now sits at its bound, so one pass over the ids tells
+    // before any strip is triangulated
+    for (std::size_t p = 1; p < parts; p++) {
+        const Index rightmost = *std::max_element(
+            m_ids.begin() + static_cast<std::ptrdiff_t>(m_part_bounds[p - 1]),
+            m_ids.begin() + static_cast<std::ptrdiff_t>(m_part_bounds[p]),
+            by_x);
+        if (!(points.x(rightmost) < points.x(m_ids[m_part_bounds[p]]))) return false;
+    }
+
+    m_parts.resize(parts);
+    m_part_coords.resize(parts);
+    m_part_extremes.resize(2 * parts);
+    m_part_failed.assign(parts, 0);
+
+    // triangulate the strips concurrently
+    const auto triangulate = [&](std::size_t p) {
+        const std::size_t begin = m_part_bounds[p];
+        const std::size_t end = m_part_bounds[p + 1];
+        std::vector<Scalar>& part_coords = m_part_coords[p];
+        part_coords.resize(2 * (end - begin));
+
+        Index leftmost = m_ids[begin];
+        Index rightmost = m_ids[begin];
+        for (std::size_t k = begin; k < end; k++) {
+            const Index i = m_ids[k];
+            part_coords[2 * (k - begin)] = points.x(i);
+            part_coords[2 * (k - begin) + 1] = points.y(i);
+            if (by_x(i, leftmost)) leftmost = i;
+            if (by_x(rightmost, i)) rightmost = i;
+        }
+        m_part_extremes[2 * p] = leftmost;
+        m_part_extremes[2 * p + 1] = rightmost;
+
+        try {
+            m_parts[p].update(part_coords);
+        } catch (const std::exception&) {
+            m_part_failed[p] = 1;
+        }
+    };
+
+    // the calling thread takes the first strip; the workers outlive this update
+    if (!m_workers) m_workers = std::make_unique<worker_pool>();
+    m_workers->run(parts, triangulate);
+
+    for (std::size_t p = 0; p < parts; p++) {
+        if (m_part_failed[p]) return false;
+    }
+
+    // concatenate the strip meshes in global point indices
+    m_part_offsets.resize(parts + 1);
+    m_part_offsets[0] = 0;
+    for (std::size_t p = 0; p < parts; p++) {
+        m_part_offsets[p + 1] = m_part_offsets[p] + m_parts[p].triangles.size();
+    }
+
+    std::size_t max_triangles = 2 * n - 5;
+    if (max_triangles * 3 >= static_cast<std::size_t>(INVALID_INDEX)) {
+        throw std::runtime_error("too many points for the index type");
+    }
+    triangles.reserve(max_triangles * 3);
+    halfedges.reserve(max_triangles * 3);
+    triangles.resize(m_part_offsets[parts]);
+    halfedges.resize(m_part_offsets[parts]);
+    hull_prev.resize(n);
+    hull_next.resize(n);
+    hull_tri.resize(n);
+
+    const auto concatenate = [&](std::size_t p) {
+        const BasicDelaunator& part = m_parts[p];
+        const Index* ids = m_ids.data() + m_part_bounds[p];
+        const Index offset = static_cast<Index>(m_part_offsets[p]);
+
+        for (std::size_t k = 0; k < part.triangles.size(); k++) {
+            const Index h = part.halfedges[k];
+            triangles[offset + k] = ids[part.triangles[k]];
+            halfedges[offset + k] = h == INVALID_INDEX ? INVALID_INDEX : static_cast<Index>(h + offset);
+        }
+
+        Index e = part.hull_start;
+        do {
+            hull_next[ids[e]] = ids[part.hull_next[e]];
+            hull_prev[ids[e]] = ids[part.hull_prev[e]];
+            hull_tri[ids[e]] = static_cast<Index>(part.hull_tri[e] + offset);
+            e = part.hull_next[e];
+        } while (e != part.hull_start);
+    };
+
+    m_workers->run(parts, concatenate);
+
+    // zip neighbouring strips together from left to right
+    const std::size_t max_flips = n;
+    const std::size_t start_flips = m_flips;
+    for (std::size_t p = 1; p < parts; p++) {
+        if (!zip(m_part_extremes[2 * p - 1], m_part_extremes[2 * p])) return false;
+        if (!legalize_seam(m_flips - start_flips, max_flips)) return false;
+    }
+    hull_start = m_part_extremes[0];
+    return true;
+}
+
+template <typename Scalar, typename Index>
+bool BasicDelaunator<Scalar, Index>::zip(Index l, Index r) {
+    point_view<Scalar> const& points = m_points;
+    const auto x = [&points](Index i) { return static_cast<double>(points.x(i)); };
+    const auto y = [&points](Index i) { return static_cast<double>(points.y(i)); };
+
+    // l is the rightmost point of the left mesh and r the leftmost point of the right one.
+    // both hulls run clockwise, so hull_next walks down the left hull's facing side and up the right one's
+    Index l0 = l;
+    Index r0 = r;
+    for (bool moved = true; moved;) {
+        moved = false;
+        while (orient(x(r0), y(r0), x(l0), y(l0), x(hull_next[l0]), y(hull_next[l0]))) {
+            l0 = hull_next[l0];
+            moved = true;
+        }
+        while (orient(x(r0), y(r0), x(l0), y(l0), x(hull_prev[r0]), y(hull_prev[r0]))) {
+            r0 = hull_prev[r0];
+            moved = true;
+        }
+    }
+
+    Index l1 = l;
+    Index r1 = r;
+    for (bool moved = true; moved;) {
+        moved = false;
+        while (orient(x(l1), y(l1), x(r1), y(r1), x(hull_prev[l1]), y(hull_prev[l1]))) {
+            l1 = hull_prev[l1];
+            moved = true;
+        }
+        while (orient(x(l1), y(l1), x(r1), y(r1), x(hull_next[r1]), y(hull_next[r1]))) {
+            r1 = hull_next[r1];
+            moved = true;
+        }
+    }
+
+    // fill the gap between the facing hull chains with a triangle fan that
+    // advances on whichever side keeps the new triangle closest to Delaunay
+    m_seam_stack.clear();
+    Index bottom = INVALID_INDEX;
+    Index base = INVALID_INDEX;
+    l = l0;
+    r = r0;
+    while (l != l1 || r != r1) {
+        const Index lc = hull_prev[l];
+        const Index rc = hull_next[r];
+        bool use_l = l != l1 && orient(x(l), y(l), x(r), y(r), x(lc), y(lc));
+        const bool use_r = r != r1 && orient(x(l), y(l), x(r), y(r), x(rc), y(rc));
+
+        if (use_l && use_r) {
+            use_l = !in_circle(x(r), y(r), x(l), y(l), x(lc), y(lc), x(rc), y(rc));
+        } else if (!use_l && !use_r) {
+            return false;
+        }
+
+        Index t;
+        if (use_l) {
+            t = add_triangle(r, l, lc, base, hull_tri[lc], INVALID_INDEX);
+            base = t + 2;
+            l = lc;
+        } else {
+            t = add_triangle(r, l, rc, base, INVALID_INDEX, hull_tri[r]);
+            base = t + 1;
+            r = rc;
+        }
+        if (bottom == INVALID_INDEX) bottom = t;
+
+        m_seam_stack.push_back(t);
+        m_seam_stack.push_back(t + 1);
+        m_seam_stack.push_back(t + 2);
+    }
+
+    if (bottom == INVALID_INDEX) return false;
+
+    // the tangents become hull edges; the chains in between are now interior
+    hull_next[r0] = l0;
+    hull_prev[l0] = r0;
+    hull_tri[r0] = bottom;
+    hull_next[l1] = r1;
+    hull_prev[r1] = l1;
+    hull_tri[l1] = base;
+    return true;
+}
+
+template <typename Scalar, typename Index>
+bool BasicDelaunator<Scalar, Index>::legalize_seam(std::size_t flips, std::size_t max_flips) {
+    point_view<Scalar> const& points = m_points;
+
+    // Lawson flips spreading out from the seam; every flip queues the four edges around the new diagonal
+    while (!m_seam_stack.empty()) {
+        const Index a = m_seam_stack.back();
+        m_seam_stack.pop_back();
+
+        const Index b = halfedges[a];
+        if (b == INVALID_INDEX) continue;
+
+        const Index a0 = 3 * (a / 3);
+        const Index b0 = 3 * (b / 3);
+        const Index al = a0 + (a + 1) % 3;
+        const Index ar = a0 + (a + 2) % 3;
+        const Index br = b0 + (b + 1) % 3;
+        const Index bl = b0 + (b + 2) % 3;
+
+        const Index p0 = triangles[ar];
+        const Index pr = triangles[a];
+        const Index pl = triangles[al];
+        const Index p1 = triangles[bl];
+
+        if (!in_circle(
+                points.x(p0), points.y(p0),
+                points.x(pr), points.y(pr),
+                points.x(pl), points.y(pl),
+                points.x(p1), points.y(p1))) {
+            continue;
+        }
+
+        // in_circle rounds too: on a near-degenerate quad that isn't convex it can ask
+        // for a flip that folds one of the new triangles over the other
+        if (orient(points.x(p1), points.y(p1), points.x(pl), points.y(pl), points.x(p0), points.y(p0)) ||
+            orient(points.x(p0), points.y(p0), points.x(pr), points.y(pr), points.x(p1), points.y(p1))) {
+            continue;
+        }
+
+        // cocircular points can make rounding flip the same edge back and forth
+        if (++flips > max_flips) return false;
+
+        flip(a);
+        m_seam_stack.push_back(a);
+        m_seam_stack.push_back(al);
+        m_seam_stack.push_back(b);
+        m_seam_stack.push_back(br);
+    }
+    return true;
+}
+
+template <typename Scalar, typename Index>
+bool BasicDelaunator<Scalar, Index>::pop_out(Index t) {
+    for (Index a = t; a < t + 3; a++) {
+        if (halfedges[a] != INVALID_INDEX) continue;
+
+        const Index al = t + (a + 1) % 3;
+        const Index ar = t + (a + 2) % 3;
+
+        // the opposite point must be interior, or dropping the triangle would orphan it
+        if (halfedges[al] == INVALID_INDEX || halfedges[ar] == INVALID_INDEX) return false;
+
+        const Index pa = triangles[a];
+        const Index pb = triangles[al];
+        const Index p = triangles[ar];
+
+        hull_next[pa] = p;
+        hull_prev[p] = pa;
+        hull_next[p] = pb;
+        hull_prev[pb] = p;
+        hull_tri[pa] = halfedges[ar];
+        hull_tri[p] = halfedges[al];
+
+        remove_triangle(t);
+        return true;
+    }
+    return false;
+}
+
+template <typename Scalar, typename Index>
+void BasicDelaunator<Scalar, Index>::remove_triangle(Index t) {
+    for (Index k = t; k < t + 3; k++) {
+        const Index b = halfedges[k];
+        if (b != INVALID_INDEX) halfedges[b] = INVALID_INDEX;
+    }
+
+    // keep the triangle array packed by moving the last triangle into the hole
+    const Index last = static_cast<Index>(triangles.size() - 3);
+    if (t != last) {
+        for (Index k = 0; k < 3; k++) {
+            const Index b = halfedges[last + k];
+            triangles[t + k] = triangles[last + k];
+            halfedges[t + k] = b;
+            if (b != INVALID_INDEX) {
+                halfedges[b] = t + k;
+            } else {
+                hull_tri[triangles[t + k]] = t + k;
+            }
+        }
+    }
+    triangles.resize(last);
+    halfedges.resize(last);
+}
+
+template <typename Scalar, typename Index>
+std::size_t BasicDelaunator<Scalar, Index>::get_hull_fixups() const {
+    return m_hull_fixups;
+}
+
+template <typename Scalar, typename Index>
+double BasicDelaunator<Scalar, Index>::get_hull_area() {
+    point_view<Scalar> const& points = m_points;
     std::vector<double> hull_area;
-    size_t e = hull_start;
+    Index e = hull_start;
     do {
-        hull_area.push_back((coords[2 * e] - coords[2 * hull_prev[e]]) * (coords[2 * e + 1] + coords[2 * hull_prev[e] + 1]));
+        hull_area.push_back((points.x(e) - points.x(hull_prev[e])) * (points.y(e) + points.y(hull_prev[e])));
         e = hull_next[e];
     } while (e != hull_start);
     return sum(hull_area);
 }
 
-std::size_t Delaunator::legalize(std::size_t a) {
+template <typename Scalar, typename Index>
+Index BasicDelaunator<Scalar, Index>::legalize(Index a) {
+    point_view<Scalar> const& points = m_points;
     std::size_t i = 0;
-    std::size_t ar = 0;
+    Index ar = 0;
     m_edge_stack.clear();
 
     // recursion eliminated with a fixed-size stack
     while (true) {
-        const size_t b = halfedges[a];
+        const Index b = halfedges[a];
 
         /* if the pair of triangles doesn't satisfy the Delaunay condition
         * (p1 is inside the circumcircle of [p0, pl, pr]), flip them,
@@ -400,7 +1891,7 @@ std::size_t Delaunator::legalize(std::size_t a) {
         *          \||/                  \  /
         *           pr                    pr
         */
-        const size_t a0 = 3 * (a / 3);
+        const Index a0 = 3 * (a / 3);
         ar = a0 + (a + 2) % 3;
 
         if (b == INVALID_INDEX) {
@@ -414,46 +1905,42 @@ std::size_t Delaunator::legalize(std::size_t a) {
             }
         }
 
-        const size_t b0 = 3 * (b / 3);
-        const size_t al = a0 + (a + 1) % 3;
-        const size_t bl = b0 + (b + 2) % 3;
+        const Index b0 = 3 * (b / 3);
+        const Index al = a0 + (a + 1) % 3;
+        const Index bl = b0 + (b + 2) % 3;
 
-        const std::size_t p0 = triangles[ar];
-        const std::size_t pr = triangles[a];
-        const std::size_t pl = triangles[al];
-        const std::size_t p1 = triangles[bl];
+        const Index p0 = triangles[ar];
+        const Index pr = triangles[a];
+        const Index pl = triangles[al];
+        const Index p1 = triangles[bl];
 
         const bool illegal = in_circle(
-            coords[2 * p0],
-            coords[2 * p0 + 1],
-            coords[2 * pr],
-            coords[2 * pr + 1],
-            coords[2 * pl],
-            coords[2 * pl + 1],
-            coords[2 * p1],
-            coords[2 * p1 + 1]);
+            points.x(p0),
+            points.y(p0),
+            points.x(pr),
+            points.y(pr),
+            points.x(pl),
+            points.y(pl),
+            points.x(p1),
+            points.y(p1));
 
         if (illegal) {
+            m_flips++;
             triangles[a] = p1;
             triangles[b] = p0;
 
             auto hbl = halfedges[bl];
 
-            // edge swapped on the other side of the hull (rare); fix the halfedge reference
-            if (hbl == INVALID_INDEX) {
-                std::size_t e = hull_start;
-                do {
-                    if (hull_tri[e] == bl) {
-                        hull_tri[e] = a;
-                        break;
-                    }
-                    e = hull_next[e];
-                } while (e != hull_start);
+            // edge swapped on the other side of the hull (rare); fix the halfedge reference.
+            // a hull halfedge starts at its hull vertex, so p1 is the entry to look at
+            if (hbl == INVALID_INDEX && hull_tri[p1] == bl) {
+                hull_tri[p1] = a;
+                m_hull_fixups++;
             }
             link(a, hbl);
             link(b, halfedges[ar]);
             link(ar, bl);
-            std::size_t br = b0 + (b + 1) % 3;
+            Index br = b0 + (b + 1) % 3;
 
             if (i < m_edge_stack.size()) {
                 m_edge_stack[i] = br;
@@ -475,7 +1962,8 @@ std::size_t Delaunator::legalize(std::size_t a) {
     return ar;
 }
 
-std::size_t Delaunator::hash_key(const double x, const double y) const {
+template <typename Scalar, typename Index>
+std::size_t BasicDelaunator<Scalar, Index>::hash_key(const double x, const double y) const {
     const double dx = x - m_center_x;
     const double dy = y - m_center_y;
     return fast_mod(
@@ -483,14 +1971,15 @@ std::size_t Delaunator::hash_key(const double x, const double y) const {
         m_hash_size);
 }
 
-std::size_t Delaunator::add_triangle(
-    std::size_t i0,
-    std::size_t i1,
-    std::size_t i2,
-    std::size_t a,
-    std::size_t b,
-    std::size_t c) {
-    std::size_t t = triangles.size();
+template <typename Scalar, typename Index>
+Index BasicDelaunator<Scalar, Index>::add_triangle(
+    Index i0,
+    Index i1,
+    Index i2,
+    Index a,
+    Index b,
+    Index c) {
+    const Index t = static_cast<Index>(triangles.size());
     triangles.push_back(i0);
     triangles.push_back(i1);
     triangles.push_back(i2);
@@ -500,7 +1989,8 @@ std::size_t Delaunator::add_triangle(
     return t;
 }
 
-void Delaunator::link(const std::size_t a, const std::size_t b) {
+template <typename Scalar, typename Index>
+void BasicDelaunator<Scalar, Index>::link(const Index a, const Index b) {
     std::size_t s = halfedges.size();
     if (a == s) {
         halfedges.push_back(b);
@@ -521,4 +2011,9 @@ void Delaunator::link(const std::size_t a, const std::size_t b) {
     }
 }
 
-} // namespace delaunator
+template class BasicDelaunator<double, std::size_t>;
+template class BasicDelaunator<double, std::uint32_t>;
+template class BasicDelaunator<float, std::size_t>;
+template class BasicDelaunator<float, std::uint32_t>;
+
+} // namespace delaunator
\ No newline at end of file
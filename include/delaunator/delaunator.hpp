@@ -1,11 +1,19 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <condition_variable>
+#include <cstdint>
 #include <exception>
+#include <functional>
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -51,12 +59,46 @@ inline std::pair<double, double> circumcenter(
     const double cy
 );
 
+// read-only view of the input points. x and y are addressed with a byte stride, so the
+// coordinates can be interleaved pairs, two separate arrays or fields of larger structs
+// (e.g. point_view<float>(&v[0].x, &v[0].y, v.size(), sizeof(v[0]))). the triangulator
+// reads through the view and keeps it between calls, so the storage must stay alive
+template <typename Scalar>
+struct point_view {
+    const Scalar* xs;
+    const Scalar* ys;
+    std::size_t count;
+    std::size_t stride; // bytes between consecutive points
+
+    point_view() : xs(nullptr), ys(nullptr), count(0), stride(0) {}
+    point_view(const Scalar* in_xs, const Scalar* in_ys, std::size_t in_count, std::size_t in_stride)
+        : xs(in_xs), ys(in_ys), count(in_count), stride(in_stride) {}
+
+    // flat [x0, y0, x1, y1, ...] coordinates
+    point_view(std::vector<Scalar> const& coords)
+        : xs(coords.data()), ys(coords.data() + 1), count(coords.size() >> 1), stride(2 * sizeof(Scalar)) {}
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    bool interleaved() const { return ys == xs + 1 && stride == 2 * sizeof(Scalar); }
+
+    Scalar x(std::size_t i) const {
+        return *reinterpret_cast<const Scalar*>(reinterpret_cast<const char*>(xs) + i * stride);
+    }
+    Scalar y(std::size_t i) const {
+        return *reinterpret_cast<const Scalar*>(reinterpret_cast<const char*>(ys) + i * stride);
+    }
+};
+
+template <typename Scalar>
 struct compare {
-    std::vector<double> const& coords;
+    point_view<Scalar> const& points;
     double cx;
     double cy;
 
-    bool operator()(std::size_t i, std::size_t j);
+    template <typename Index>
+    bool operator()(Index i, Index j);
 };
 
 constexpr double EPSILON = std::numeric_limits<double>::epsilon();
@@ -72,8 +114,41 @@ inline bool in_circle(
     const double py
 );
 
+// instruction set of the batched predicates (the seed search, the hull visibility
+// walk and the Delaunay pass of repair()), which test 2, 4 or 8 candidates at once.
+// the best one the CPU supports is picked on first use; set_simd_level lowers it
+// (never above what the CPU has). every level produces the same triangulation
+enum class simd_level { scalar, sse2, avx2, avx512 };
+
+simd_level get_simd_level();
+void set_simd_level(simd_level level);
+
 constexpr std::size_t INVALID_INDEX = std::numeric_limits<std::size_t>::max();
 
+// a kinetic repair gives up and rebuilds once it needs more than n / KINETIC_FLIP_DIVISOR flips
+constexpr std::size_t KINETIC_FLIP_DIVISOR = 4;
+constexpr std::size_t KINETIC_MIN_FLIPS = 32;
+
+// a fold no flip can undo is fixed by taking one of its points out and inserting it
+// again; only points with at most KINETIC_MAX_DEGREE neighbours are taken out, and
+// finding the point's new triangle gives up after KINETIC_WALK_STEPS triangles
+constexpr std::size_t KINETIC_MAX_DEGREE = 32;
+constexpr std::size_t KINETIC_WALK_STEPS = 64;
+
+// insertion order: below this many points std::sort with compare, above it a radix
+// sort over precomputed distance keys, RADIX_SORT_BITS per pass
+constexpr std::size_t RADIX_SORT_MIN_POINTS = 512;
+constexpr unsigned RADIX_SORT_BITS = 11;
+
+// a sweep whose seed triangle matches the last one re-sorts the last insertion order
+// with an insertion sort, falling back to a full sort after this many shifts per point;
+// after a fallback the next COHERENT_SORT_BACKOFF sweeps sort from scratch
+constexpr std::size_t COHERENT_SORT_MAX_SHIFTS = 32;
+constexpr std::size_t COHERENT_SORT_BACKOFF = 16;
+
+// the parallel build only splits off strips of at least this many points
+constexpr std::size_t PARALLEL_MIN_POINTS = 16384;
+
 inline bool check_pts_equal(double x1, double y1, double x2, double y2);
 
 // monotonically increases with real angle, but doesn't need expensive trigonometry
@@ -89,46 +164,162 @@ struct DelaunatorPoint {
     bool removed;
 };
 
-class Delaunator {
+// threads kept alive between parallel builds. run(count, task) calls task(0) on the
+// calling thread and task(1) .. task(count - 1) on workers, which are started on
+// first use and then wait for the next run instead of exiting
+class worker_pool {
 public:
-    std::vector<double> const& coords;
-    std::vector<std::size_t> triangles;
-    std::vector<std::size_t> halfedges;
-    std::vector<std::size_t> hull_prev;
-    std::vector<std::size_t> hull_next;
-    std::vector<std::size_t> hull_tri;
-    std::size_t hull_start;
+    worker_pool() = default;
+    ~worker_pool();
+
+    worker_pool(const worker_pool&) = delete;
+    worker_pool& operator=(const worker_pool&) = delete;
 
-    Delaunator(std::vector<double> const& in_coords);
-    ~Delaunator() = default;
+    void run(std::size_t count, const std::function<void(std::size_t)>& task);
 
-    // Prevent copying (due to reference member)
-    Delaunator(const Delaunator&) = delete;
-    Delaunator& operator=(const Delaunator&) = delete;
+private:
+    void work(std::size_t index, std::size_t generation);
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    const std::function<void(std::size_t)>* m_task = nullptr;
+    std::size_t m_count = 0;
+    std::size_t m_generation = 0;
+    std::size_t m_pending = 0;
+    bool m_stop = false;
+    std::vector<std::thread> m_threads;
+};
+
+// Scalar is the coordinate type (float or double) and Index the type of the
+// triangles/halfedges/hull arrays (std::uint32_t or std::size_t). the geometric
+// predicates always run in double, so float coordinates are widened before
+// orient/in_circle and degenerate float inputs are classified like double ones
+template <typename Scalar, typename Index>
+class BasicDelaunator {
+    static_assert(std::is_floating_point_v<Scalar>, "Scalar must be a floating point type");
+    static_assert(std::is_unsigned_v<Index> && sizeof(Index) >= sizeof(std::uint32_t),
+                  "Index must be an unsigned type of at least 32 bits");
+
+public:
+    using scalar_type = Scalar;
+    using index_type = Index;
+
+    static constexpr Index INVALID_INDEX = std::numeric_limits<Index>::max();
+
+    std::vector<Index> triangles;
+    std::vector<Index> halfedges;
+    std::vector<Index> hull_prev;
+    std::vector<Index> hull_next;
+    std::vector<Index> hull_tri;
+    Index hull_start;
+
+    BasicDelaunator();
+    BasicDelaunator(point_view<Scalar> in_points);
+    ~BasicDelaunator() = default;
+
+    // Prevent copying (keeps a view of the caller's coordinates)
+    BasicDelaunator(const BasicDelaunator&) = delete;
+    BasicDelaunator& operator=(const BasicDelaunator&) = delete;
 
     // Allow moving
-    Delaunator(Delaunator&&) = default;
-    Delaunator& operator=(Delaunator&&) = default;
+    BasicDelaunator(BasicDelaunator&&) = default;
+    BasicDelaunator& operator=(BasicDelaunator&&) = default;
+
+    // retriangulate in place; every buffer keeps its capacity between calls,
+    // so repeated updates with the same point count do not allocate.
+    // with threads > 1 large inputs are split into vertical strips that are
+    // triangulated concurrently and zipped together with Delaunay flips; the
+    // worker threads are started once and reused by later updates
+    void update(point_view<Scalar> in_points, std::size_t threads = 1);
+
+    // kinetic update for points that moved slightly since the last call: patch the
+    // hull where points crossed it, untangle inverted triangles with local edge flips
+    // (or by reinserting a point where no flip helps) and restore the Delaunay
+    // condition. falls back to update() when the point count changed or the repair
+    // gets too large; returns false in that case
+    bool repair(point_view<Scalar> in_points, std::size_t threads = 1);
 
     double get_hull_area();
 
+    // how many flips so far swapped a hull edge into another halfedge slot
+    std::size_t get_hull_fixups() const;
+
 private:
-    std::vector<std::size_t> m_hash;
+    point_view<Scalar> m_points;
+    std::vector<Index> m_ids;
+    std::vector<Index> m_ids_tmp;
+    std::vector<std::uint64_t> m_keys;
+    std::vector<std::uint64_t> m_keys_tmp;
+    bool m_ids_sorted;
+    std::array<Index, 3> m_seed;
+    std::size_t m_resort_skip;
+    std::vector<Index> m_hash;
     double m_center_x;
     double m_center_y;
     std::size_t m_hash_size;
-    std::vector<std::size_t> m_edge_stack;
+    std::vector<Index> m_edge_stack;
+    std::size_t m_flips;
+    std::size_t m_hull_fixups;
+
+    // per-strip state of the parallel build
+    std::vector<BasicDelaunator> m_parts;
+    std::vector<std::vector<Scalar>> m_part_coords;
+    std::vector<std::size_t> m_part_bounds;
+    std::vector<std::size_t> m_part_offsets;
+    std::vector<Index> m_part_extremes;
+    std::vector<char> m_part_failed;
+    std::unique_ptr<worker_pool> m_workers;
+    std::vector<Index> m_seam_stack;
 
-    std::size_t legalize(std::size_t a);
+    // kinetic repair: inverted triangles still to check, those no flip could undo,
+    // and the hole a reinserted point leaves (its neighbours in order, the halfedges
+    // across the hole's boundary, the freed triangle slots and the ears that fill it)
+    std::vector<Index> m_tangled;
+    std::vector<Index> m_stuck;
+    std::vector<Index> m_link_points;
+    std::vector<Index> m_link_outer;
+    std::vector<Index> m_link_slots;
+    std::vector<std::size_t> m_link_order;
+    std::vector<std::size_t> m_ears;
+
+    void sweep();
+    void sort_by_distance();
+    bool resort_by_distance();
+    bool build_parallel(std::size_t threads);
+    bool zip(Index l, Index r);
+    bool legalize_seam(std::size_t flips, std::size_t max_flips);
+    Index legalize(Index a);
+    bool is_inverted(Index t) const;
+    bool untangle(Index t);
+    bool reinsert(Index start);
+    bool clip_link(Index e);
+    Index locate(Index t, Index p, bool& outside) const;
+    bool attach(Index a, Index p, Index t, Index spare);
+    bool pop_out(Index t);
+    void flip(Index a);
+    void remove_triangle(Index t);
     std::size_t hash_key(double x, double y) const;
-    std::size_t add_triangle(
-        std::size_t i0,
-        std::size_t i1,
-        std::size_t i2,
-        std::size_t a,
-        std::size_t b,
-        std::size_t c);
-    void link(std::size_t a, std::size_t b);
+    Index add_triangle(
+        Index i0,
+        Index i1,
+        Index i2,
+        Index a,
+        Index b,
+        Index c);
+    void link(Index a, Index b);
 };
 
+// the original double/size_t triangulator
+using Delaunator = BasicDelaunator<double, std::size_t>;
+
+// float32 coordinates and 32-bit indices; half the memory of Delaunator and
+// the index array matches GL_UNSIGNED_INT
+using Delaunator32 = BasicDelaunator<float, std::uint32_t>;
+
+extern template class BasicDelaunator<double, std::size_t>;
+extern template class BasicDelaunator<double, std::uint32_t>;
+extern template class BasicDelaunator<float, std::size_t>;
+extern template class BasicDelaunator<float, std::uint32_t>;
+
 } // namespace delaunator
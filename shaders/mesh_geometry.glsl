@@ -0,0 +1,32 @@
+#version 330 core
+layout (triangles) in;
+layout (triangle_strip, max_vertices = 3) out;
+
+// background colors from the bottom of the screen to the top
+uniform samplerBuffer gradientStops;
+uniform int gradientStopCount;
+
+out vec4 vColor;
+
+vec4 gradient(float t) {
+    if (gradientStopCount == 0) return vec4(0.0, 0.0, 0.0, 1.0);
+    if (gradientStopCount == 1 || t <= 0.0) return texelFetch(gradientStops, 0);
+    if (t >= 1.0) return texelFetch(gradientStops, gradientStopCount - 1);
+
+    float scaled = t * float(gradientStopCount - 1);
+    int index = int(scaled);
+    return mix(texelFetch(gradientStops, index), texelFetch(gradientStops, index + 1), scaled - float(index));
+}
+
+void main() {
+    // the whole triangle takes the color at its centroid height
+    float cy = (gl_in[0].gl_Position.y + gl_in[1].gl_Position.y + gl_in[2].gl_Position.y) / 3.0;
+    vec4 color = gradient((cy + 1.0) * 0.5);
+
+    for (int i = 0; i < 3; ++i) {
+        gl_Position = gl_in[i].gl_Position;
+        vColor = color;
+        EmitVertex();
+    }
+    EndPrimitive();
+}
\ No newline at end of file
@@ -0,0 +1,9 @@
+#version 330 core
+layout (location = 0) in float aX;
+layout (location = 1) in float aY;
+
+uniform float aspectRatio;
+
+void main() {
+    gl_Position = vec4(aX / aspectRatio, aY, 0.0, 1.0);
+}
\ No newline at end of file
@@ -30,15 +30,6 @@ namespace delaunay_flow {
 Application::Application()
     : settings_(Settings::Instance()),
       window_(settings_.MSAA),
-      starSystem_(
-          settings_,
-          Rect(
-              (-settings_.offsetBounds - 1.0f) * (window_.width() / window_.height()),
-              ( settings_.offsetBounds + 1.0f) * (window_.width() / window_.height()),
-               -settings_.offsetBounds - 1.0f,
-                settings_.offsetBounds + 1.0f
-          )
-      ),
       renderer_(settings_, window_.width(), window_.height())
 {
     width_       = window_.width();
@@ -47,8 +38,6 @@ Application::Application()
     iWidth_      = window_.widthPx();
     iHeight_     = window_.heightPx();
 
-    initInterpolation(settings_.backGroundColors);
-
     initWindow();
     initOpenGL();
     initTrayAndWallpaper();
@@ -63,24 +52,31 @@ void Application::initWindow() {
     SetWindowLongPtr(window_.hwnd(), GWLP_USERDATA, std::bit_cast<LONG_PTR>(this));
     SetWindowLongPtr(window_.hwnd(), GWLP_WNDPROC,  std::bit_cast<LONG_PTR>(&Application::WndProc));
 
-    starSystem_ = StarSystem(
-        settings_,
+    const std::size_t triangulationThreads = settings_.triangulation.threads > 0
+        ? static_cast<std::size_t>(settings_.triangulation.threads)
+        : std::max<std::size_t>(std::thread::hardware_concurrency(), 1U);
+
+    simulation_ = std::make_unique<SimulationThread>(
+        starSystemParams(settings_),
         Rect(
             (-settings_.offsetBounds - 1.0f) * aspectRatio_,
             ( settings_.offsetBounds + 1.0f) * aspectRatio_,
              -settings_.offsetBounds - 1.0f,
               settings_.offsetBounds + 1.0f
-        )
+        ),
+        settings_.triangulation.kinetic,
+        triangulationThreads,
+        settings_.simulation.traceMode,
+        settings_.simulation.traceFile
     );
 
     glfwGetCursorPos(window_.get(), &mouseX_, &mouseY_);
-    mouseXNDC_ =   static_cast<float>(mouseX_) / width_  * 2.0f - 1.0f;
+    mouseXNDC_ =  (static_cast<float>(mouseX_) / width_  * 2.0f - 1.0f) * aspectRatio_;
     mouseYNDC_ = -(static_cast<float>(mouseY_) / height_ * 2.0f - 1.0f);
+    publishSources();
 }
 
 void Application::initOpenGL() {
-    Star::init(settings_.interaction.mouseInteraction);
-
     stepInterval_ = std::chrono::duration<float>(1.0f / static_cast<float>(settings_.targetFPS));
 
     if (settings_.vsync) {
@@ -91,8 +87,6 @@ void Application::initOpenGL() {
         tickFunc_ = &sleepTick;
     }
 
-    renderer_.rebuildStaticData(settings_, starSystem_, coords_, vertices_);
-
     wallpaper::tray::StartTrayMenuThread(window_.hwnd());
 }
 
@@ -209,23 +203,19 @@ void Application::mainLoop() {
         mouseXNDC_ = (static_cast<float>(mouseX_) / width_ * 2.0f - 1.0f) * aspectRatio_;
         mouseYNDC_ = -(static_cast<float>(mouseY_) / height_ * 2.0f - 1.0f);
 
+        publishSources();
+
         if (restartRequested_.exchange(false)) {
-            starSystem_.reset();
-            renderer_.rebuildStaticData(settings_, starSystem_, coords_, vertices_);
+            simulation_->requestReset();
         }
 
-        starSystem_.update(dt, mouseXNDC_, mouseYNDC_);
-
-        for (std::size_t i = 0; i < starSystem_.stars().size(); ++i) {
-            const std::size_t idx = 2U * i;
-            coords_[idx]          = static_cast<double>(starSystem_.stars()[i].getX());
-            coords_[idx + 1U]     = static_cast<double>(starSystem_.stars()[i].getY());
+        // stars move and get triangulated on the simulation thread; this thread only
+        // turns the newest finished frame into geometry, and redraws the last one otherwise
+        if (simulation_->acquire()) {
+            renderer_.updateFrameGeometry(settings_, simulation_->snapshot());
+            renderer_.uploadMesh(simulation_->snapshot());
         }
 
-        delaunator::Delaunator delaunator(coords_);
-
-        renderer_.updateFrameGeometry(settings_, starSystem_, coords_, vertices_, delaunator);
-        renderer_.uploadVertices(vertices_);
         renderer_.render(static_cast<float>(mouseX_), static_cast<float>(mouseY_));
 
         glfwSwapBuffers(window_.get());
@@ -248,6 +238,19 @@ void Application::mainLoop() {
     );
 
     wallpaper::tray::UnregisterIcon(window_.hwnd());
+
+    simulation_.reset();
+}
+
+void Application::publishSources() {
+    sources_.clear();
+
+    if (settings_.interaction.mouseInteraction) {
+        sources_.push_back({ mouseXNDC_, mouseYNDC_, settings_.interaction.distanceFromMouse, 1.0f, Falloff::Hard });
+    }
+    sources_.insert(sources_.end(), settings_.interaction.sources.begin(), settings_.interaction.sources.end());
+
+    simulation_->setSources(sources_);
 }
 
 } // namespace delaunay_flow
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include <flow_field.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace delaunay_flow {
+
+namespace {
+
+// table samples per swirl; bilinear reads between them stay smooth at 4
+constexpr float kSamplesPerScale = 4.0f;
+
+// keeps a tiny scale from asking for a huge table
+constexpr int kMaxSamplesPerAxis = 256;
+
+// the potential fades out over this share of a swirl next to each bound
+constexpr float kEdgeFade = 0.5f;
+
+// the next layer is finished this far into the cross-fade before it, which leaves
+// slack for long steps
+constexpr float kBuildAhead = 0.5f;
+
+std::uint32_t hash(std::uint32_t x) noexcept {
+    x ^= x >> 16U;
+    x *= 0x7FEB352DU;
+    x ^= x >> 15U;
+    x *= 0x846CA68BU;
+    x ^= x >> 16U;
+    return x;
+}
+
+float smoothstep(float t) noexcept {
+    t = std::clamp(t, 0.0f, 1.0f);
+    return t * t * (3.0f - 2.0f * t);
+}
+
+// 2D gradient noise: a random unit gradient per lattice point, quintic blending
+float gradientNoise(float x, float y, std::uint32_t key) noexcept {
+    const float x0 = std::floor(x);
+    const float y0 = std::floor(y);
+    const auto  ix = static_cast<std::uint32_t>(static_cast<std::int32_t>(x0));
+    const auto  iy = static_cast<std::uint32_t>(static_cast<std::int32_t>(y0));
+    const float fx = x - x0;
+    const float fy = y - y0;
+
+    const auto corner = [key](std::uint32_t cx, std::uint32_t cy, float dx, float dy) {
+        const float angle = static_cast<float>(hash(cx * 0x9E3779B1U ^ hash(cy ^ key))) * (TAU_F / 4294967296.0f);
+        return std::cos(angle) * dx + std::sin(angle) * dy;
+    };
+
+    const float n00 = corner(ix,      iy,      fx,        fy);
+    const float n10 = corner(ix + 1U, iy,      fx - 1.0f, fy);
+    const float n01 = corner(ix,      iy + 1U, fx,        fy - 1.0f);
+    const float n11 = corner(ix + 1U, iy + 1U, fx - 1.0f, fy - 1.0f);
+
+    const float u = fx * fx * fx * (fx * (fx * 6.0f - 15.0f) + 10.0f);
+    const float v = fy * fy * fy * (fy * (fy * 6.0f - 15.0f) + 10.0f);
+
+    const float bottom = n00 + (n10 - n00) * u;
+    const float top    = n01 + (n11 - n01) * u;
+    return bottom + (top - bottom) * v;
+}
+
+}  // namespace
+
+void FlowField::reset(const Rect& bounds, float scale, float refresh, std::uint32_t seed) {
+    const float width  = bounds.right - bounds.left;
+    const float height = bounds.top - bounds.bottom;
+
+    bounds_  = bounds;
+    scale_   = scale;
+    refresh_ = refresh;
+    spacing_ = std::max({ scale / kSamplesPerScale,
+                          width / static_cast<float>(kMaxSamplesPerAxis - 1),
+                          height / static_cast<float>(kMaxSamplesPerAxis - 1) });
+    columns_ = std::clamp(static_cast<int>(std::ceil(width / spacing_)) + 1, 2, kMaxSamplesPerAxis);
+    rows_    = std::clamp(static_cast<int>(std::ceil(height / spacing_)) + 1, 2, kMaxSamplesPerAxis);
+    seed_    = seed;
+    layer_   = 0;
+    time_    = 0.0f;
+
+    buildLayer(layer_, fromX_, fromY_);
+    buildLayer(layer_ + 1U, toX_, toY_);
+
+    const std::size_t cells = static_cast<std::size_t>(columns_) * static_cast<std::size_t>(rows_);
+    nextX_.resize(cells);
+    nextY_.resize(cells);
+    nextRows_  = 0;
+    nextSpeed_ = 0.0f;
+}
+
+void FlowField::advance(float dt) {
+    if (columns_ == 0) {
+        return;
+    }
+
+    time_ += dt;
+    while (time_ >= refresh_) {
+        time_ -= refresh_;
+        buildNext(rows_);  // only left over after a very long step
+        ++layer_;
+        std::swap(fromX_, toX_);
+        std::swap(fromY_, toY_);
+        std::swap(toX_, nextX_);
+        std::swap(toY_, nextY_);
+        nextRows_  = 0;
+        nextSpeed_ = 0.0f;
+    }
+
+    const float progress = std::min(time_ / (kBuildAhead * refresh_), 1.0f);
+    buildNext(static_cast<int>(std::ceil(progress * static_cast<float>(rows_))));
+}
+
+FlowTable FlowField::table() const noexcept {
+    return { fromX_.data(), fromY_.data(), toX_.data(), toY_.data(), smoothstep(time_ / refresh_),
+             columns_, rows_, bounds_.left, bounds_.bottom, 1.0f / spacing_ };
+}
+
+float FlowField::potential(float x, float y, std::uint32_t layer) const noexcept {
+    const std::uint32_t key = hash(seed_ ^ hash(layer));
+
+    const float nx = (x - bounds_.left) / scale_;
+    const float ny = (y - bounds_.bottom) / scale_;
+    const float noise = gradientNoise(nx, ny, key) + 0.5f * gradientNoise(2.0f * nx, 2.0f * ny, hash(key + 1U));
+
+    const float fade = kEdgeFade * scale_;
+    return noise
+        * smoothstep((x - bounds_.left) / fade) * smoothstep((bounds_.right - x) / fade)
+        * smoothstep((y - bounds_.bottom) / fade) * smoothstep((bounds_.top - y) / fade);
+}
+
+void FlowField::buildLayer(std::uint32_t layer, std::vector<float>& vx, std::vector<float>& vy) const {
+    const std::size_t cells = static_cast<std::size_t>(columns_) * static_cast<std::size_t>(rows_);
+    vx.resize(cells);
+    vy.resize(cells);
+
+    float totalSpeed = 0.0f;
+    buildRows(layer, vx, vy, 0, rows_, totalSpeed);
+}
+
+void FlowField::buildRows(std::uint32_t layer, std::vector<float>& vx, std::vector<float>& vy,
+                          int begin, int end, float& totalSpeed) const {
+    // velocity = (d/dy, -d/dx) of the potential, which has no divergence
+    const float h = 0.5f * spacing_;
+    for (int row = begin; row < end; ++row) {
+        const float y = bounds_.bottom + static_cast<float>(row) * spacing_;
+        for (int col = 0; col < columns_; ++col) {
+            const float x = bounds_.left + static_cast<float>(col) * spacing_;
+            const std::size_t i = static_cast<std::size_t>(row) * static_cast<std::size_t>(columns_) + static_cast<std::size_t>(col);
+
+            vx[i] =  (potential(x, y + h, layer) - potential(x, y - h, layer)) / (2.0f * h);
+            vy[i] = -(potential(x + h, y, layer) - potential(x - h, y, layer)) / (2.0f * h);
+            totalSpeed += std::sqrt(vx[i] * vx[i] + vy[i] * vy[i]);
+        }
+    }
+
+    // an average current moves a star at its own speed; the last rows scale the whole layer
+    if (end == rows_ && totalSpeed > 0.0f) {
+        const float normalize = static_cast<float>(vx.size()) / totalSpeed;
+        for (std::size_t i = 0; i < vx.size(); ++i) {
+            vx[i] *= normalize;
+            vy[i] *= normalize;
+        }
+    }
+}
+
+// build layer_ + 2 up to `rows` rows
+void FlowField::buildNext(int rows) {
+    rows = std::min(rows, rows_);
+    if (rows <= nextRows_) {
+        return;
+    }
+    buildRows(layer_ + 2U, nextX_, nextY_, nextRows_, rows, nextSpeed_);
+    nextRows_ = rows;
+}
+
+}  // namespace delaunay_flow
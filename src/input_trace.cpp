@@ -0,0 +1,138 @@
+#include <input_trace.hpp>
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <string>
+
+namespace delaunay_flow {
+
+namespace {
+
+constexpr std::array<char, 4> kTraceMagic   = { 'D', 'F', 'T', 'R' };
+constexpr std::uint32_t       kTraceVersion = 3;
+
+constexpr std::uint8_t kFrameReset = 0x1U;
+
+template <typename T>
+void put(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool get(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+}  // namespace
+
+TraceWriter::TraceWriter(const std::filesystem::path& file, const TraceHeader& header)
+    : out_(file, std::ios::binary | std::ios::trunc)
+{
+    if (!out_.is_open())
+        throw std::runtime_error(
+            "Could not create the trace file:\n" + file.string());
+
+    out_.write(kTraceMagic.data(), kTraceMagic.size());
+    put(out_, kTraceVersion);
+    put(out_, header.seed);
+    put(out_, header.count);
+    put(out_, header.minSpeed);
+    put(out_, header.maxSpeed);
+    put(out_, header.stepRate);
+    put(out_, header.separation);
+    put(out_, header.separationStiffness);
+    put(out_, static_cast<std::uint8_t>(header.motion));
+    put(out_, header.flowScale);
+    put(out_, header.flowRefresh);
+    put(out_, header.bounds.left);
+    put(out_, header.bounds.right);
+    put(out_, header.bounds.bottom);
+    put(out_, header.bounds.top);
+}
+
+void TraceWriter::write(const TraceFrame& frame) {
+    // a frame never carries more sources than fit its one-byte count
+    const std::size_t count = std::min<std::size_t>(frame.sources.size(), 255U);
+
+    put(out_, frame.frameTime);
+    put(out_, static_cast<std::uint8_t>(frame.reset ? kFrameReset : 0U));
+    put(out_, static_cast<std::uint8_t>(count));
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const InteractionSource& source = frame.sources[i];
+        put(out_, source.x);
+        put(out_, source.y);
+        put(out_, source.radius);
+        put(out_, source.strength);
+        put(out_, static_cast<std::uint8_t>(source.falloff));
+    }
+}
+
+TraceReader::TraceReader(const std::filesystem::path& file)
+    : in_(file, std::ios::binary)
+{
+    if (!in_.is_open())
+        throw std::runtime_error(
+            "Could not open the trace file:\n" + file.string() +
+            "\n\nPlease make sure the file exists and is accessible.");
+
+    std::array<char, 4> magic{};
+    std::uint32_t       version = 0;
+    in_.read(magic.data(), magic.size());
+
+    if (!in_ || magic != kTraceMagic || !get(in_, version) || version != kTraceVersion)
+        throw std::runtime_error(
+            "Invalid trace file:\n" + file.string() +
+            "\n\nIt was not written by this version of the recorder.");
+
+    std::uint8_t motion = 0;
+    const bool complete =
+        get(in_, header_.seed) &&
+        get(in_, header_.count) &&
+        get(in_, header_.minSpeed) &&
+        get(in_, header_.maxSpeed) &&
+        get(in_, header_.stepRate) &&
+        get(in_, header_.separation) &&
+        get(in_, header_.separationStiffness) &&
+        get(in_, motion) &&
+        get(in_, header_.flowScale) &&
+        get(in_, header_.flowRefresh) &&
+        get(in_, header_.bounds.left) &&
+        get(in_, header_.bounds.right) &&
+        get(in_, header_.bounds.bottom) &&
+        get(in_, header_.bounds.top);
+
+    header_.motion = static_cast<Motion>(motion);
+
+    if (!complete || header_.count == 0 || !(header_.stepRate > 0.0f) ||
+        motion > static_cast<std::uint8_t>(Motion::Flow) ||
+        (header_.motion == Motion::Flow && !(header_.flowScale > 0.0f && header_.flowRefresh > 0.0f)))
+        throw std::runtime_error(
+            "Invalid trace file:\n" + file.string() +
+            "\n\nIts header is damaged.");
+}
+
+bool TraceReader::next(TraceFrame& frame) {
+    std::uint8_t flags = 0;
+    std::uint8_t count = 0;
+    if (!get(in_, frame.frameTime) || !get(in_, flags) || !get(in_, count)) {
+        return false;
+    }
+
+    frame.reset = (flags & kFrameReset) != 0;
+    frame.sources.resize(count);
+
+    for (InteractionSource& source : frame.sources) {
+        std::uint8_t falloff = 0;
+        if (!get(in_, source.x) || !get(in_, source.y) || !get(in_, source.radius) ||
+            !get(in_, source.strength) || !get(in_, falloff) ||
+            falloff > static_cast<std::uint8_t>(Falloff::Smooth)) {
+            return false;
+        }
+        source.falloff = static_cast<Falloff>(falloff);
+    }
+    return true;
+}
+
+}  // namespace delaunay_flow
@@ -3,6 +3,8 @@
 #define GLFW_EXPOSE_NATIVE_WIN32
 #include <GLFW/glfw3native.h>
 
+#include <cstdint>
+#include <numeric>
 #include <stdexcept>
 #include <utility>
 
@@ -189,6 +191,226 @@ void ArrayBuffer::reset() noexcept {
     }
 }
 
+// ElementBuffer implementation
+ElementBuffer::ElementBuffer() {
+    glGenBuffers(1, &id_);
+    if (id_ == 0U) {
+        throw std::runtime_error("Failed to create EBO");
+    }
+}
+
+ElementBuffer::~ElementBuffer() noexcept {
+    reset();
+}
+
+ElementBuffer::ElementBuffer(ElementBuffer&& other) noexcept 
+    : id_(other.id_) {
+    other.id_ = 0U;
+}
+
+ElementBuffer& ElementBuffer::operator=(ElementBuffer&& other) noexcept {
+    if (this != &other) {
+        reset();
+        id_       = other.id_;
+        other.id_ = 0U;
+    }
+    return *this;
+}
+
+void ElementBuffer::bind() const noexcept { 
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, id_); 
+}
+
+GLuint ElementBuffer::id() const noexcept { 
+    return id_; 
+}
+
+void ElementBuffer::reset() noexcept {
+    if (id_ != 0U) {
+        glDeleteBuffers(1, &id_);
+        id_ = 0U;
+    }
+}
+
+// StreamBuffer implementation
+namespace {
+
+constexpr std::size_t kRegionAlignment = 64U;
+
+}  // namespace
+
+StreamBuffer::StreamBuffer(GLenum target)
+    : target_(target) {
+    glGenBuffers(1, &id_);
+    if (id_ == 0U) {
+        throw std::runtime_error("Failed to create stream buffer");
+    }
+}
+
+StreamBuffer::~StreamBuffer() noexcept {
+    reset();
+}
+
+StreamBuffer::StreamBuffer(StreamBuffer&& other) noexcept 
+    : id_(std::exchange(other.id_, 0U))
+    , target_(other.target_)
+    , regionBytes_(std::exchange(other.regionBytes_, 0U))
+    , region_(std::exchange(other.region_, 0U))
+    , mapped_(std::exchange(other.mapped_, false))
+    , mapFailed_(std::exchange(other.mapFailed_, false))
+    , fences_(std::exchange(other.fences_, {})) {}
+
+StreamBuffer& StreamBuffer::operator=(StreamBuffer&& other) noexcept {
+    if (this != &other) {
+        reset();
+        id_          = std::exchange(other.id_, 0U);
+        target_      = other.target_;
+        regionBytes_ = std::exchange(other.regionBytes_, 0U);
+        region_      = std::exchange(other.region_, 0U);
+        mapped_      = std::exchange(other.mapped_, false);
+        mapFailed_   = std::exchange(other.mapFailed_, false);
+        fences_      = std::exchange(other.fences_, {});
+    }
+    return *this;
+}
+
+void StreamBuffer::bind() const noexcept { 
+    glBindBuffer(target_, id_); 
+}
+
+void* StreamBuffer::mapBytes(const std::size_t bytes, const std::size_t stride) {
+    bind();
+
+    if (bytes > regionBytes_ || regionBytes_ % stride != 0U) {
+        // half again as much as asked, so a growing frame doesn't reallocate every time;
+        // whole elements per region keep first() exact, and whole cache lines keep
+        // every region as aligned as the buffer's start
+        const std::size_t unit = std::lcm(stride, kRegionAlignment);
+        regionBytes_ = (bytes + bytes / 2U + unit - 1U) / unit * unit;
+        region_      = 0U;
+
+        // fresh storage: the GPU keeps reading the old one, so no region is busy
+        clearFences();
+        glBufferData(target_, static_cast<GLsizeiptr>(regionBytes_ * kRegions), nullptr, GL_STREAM_DRAW);
+    } else {
+        region_ = (region_ + 1U) % kRegions;
+
+        GLsync& fence = fences_[region_];
+        if (fence != nullptr) {
+            while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, UINT64_C(1000000000)) == GL_TIMEOUT_EXPIRED) {
+            }
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+
+    if (bytes == 0U) {
+        mapFailed_ = false;
+        return nullptr;
+    }
+
+    void* data = glMapBufferRange(
+        target_,
+        static_cast<GLintptr>(region_ * regionBytes_),
+        static_cast<GLsizeiptr>(bytes),
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT
+    );
+    mapped_    = data != nullptr;
+    mapFailed_ = data == nullptr;
+    return data;
+}
+
+bool StreamBuffer::unmap() noexcept {
+    if (!mapped_) {
+        // nothing was mapped: fine for an empty map, data lost if the map failed
+        return !std::exchange(mapFailed_, false);
+    }
+
+    mapped_ = false;
+    bind();
+    // GL_FALSE: the storage was lost while mapped (e.g. a display mode change)
+    return glUnmapBuffer(target_) == GL_TRUE;
+}
+
+void StreamBuffer::fence() noexcept {
+    GLsync& fence = fences_[region_];
+    if (fence != nullptr) {
+        glDeleteSync(fence);
+    }
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void StreamBuffer::clearFences() noexcept {
+    for (GLsync& fence : fences_) {
+        if (fence != nullptr) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+}
+
+void StreamBuffer::reset() noexcept {
+    clearFences();
+    if (id_ != 0U) {
+        if (mapped_) {
+            bind();
+            glUnmapBuffer(target_);
+            mapped_ = false;
+        }
+        glDeleteBuffers(1, &id_);
+        id_ = 0U;
+    }
+}
+
+// TextureBuffer implementation
+TextureBuffer::TextureBuffer(GLenum format) {
+    glGenBuffers(1, &buffer_);
+    glGenTextures(1, &texture_);
+    if (buffer_ == 0U || texture_ == 0U) {
+        reset();
+        throw std::runtime_error("Failed to create buffer texture");
+    }
+
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer_);
+    glBindTexture(GL_TEXTURE_BUFFER, texture_);
+    glTexBuffer(GL_TEXTURE_BUFFER, format, buffer_);
+    glBindTexture(GL_TEXTURE_BUFFER, 0U);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0U);
+}
+
+TextureBuffer::~TextureBuffer() noexcept {
+    reset();
+}
+
+TextureBuffer::TextureBuffer(TextureBuffer&& other) noexcept 
+    : buffer_(std::exchange(other.buffer_, 0U))
+    , texture_(std::exchange(other.texture_, 0U)) {}
+
+TextureBuffer& TextureBuffer::operator=(TextureBuffer&& other) noexcept {
+    if (this != &other) {
+        reset();
+        buffer_  = std::exchange(other.buffer_, 0U);
+        texture_ = std::exchange(other.texture_, 0U);
+    }
+    return *this;
+}
+
+void TextureBuffer::bind(GLuint unit) const noexcept {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_BUFFER, texture_);
+}
+
+void TextureBuffer::reset() noexcept {
+    if (texture_ != 0U) {
+        glDeleteTextures(1, &texture_);
+        texture_ = 0U;
+    }
+    if (buffer_ != 0U) {
+        glDeleteBuffers(1, &buffer_);
+        buffer_ = 0U;
+    }
+}
+
 // WinIcon implementation
 WinIcon::WinIcon(HICON icon) noexcept : icon_(icon) {}
 
@@ -1,25 +1,129 @@
 // renderer.cpp
 #include <renderer.hpp>
 #include <shader_utils.hpp>
-#include <star_system.hpp>
 
 #include <shaders.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <numeric>
+#include <thread>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 namespace delaunay_flow {
 
+namespace {
+
+// triangle corners, halfedges or stars per parallel range; also the halfedge
+// chunk size, so the edge vertex offsets don't depend on the thread count
+constexpr std::size_t kGeometryGrain = 4096;
+
+std::size_t renderThreads(const Settings& settings) {
+    return settings.renderThreads > 0
+        ? static_cast<std::size_t>(settings.renderThreads)
+        : std::max<std::size_t>(std::thread::hardware_concurrency(), 1U);
+}
+
+#if defined(__AVX2__)
+
+constexpr std::size_t kEdgeLanes = 8;
+
+// pairs of (x, y) from lanes 0..7 of two vectors, with room to load 4 floats at the last pair
+struct PointLanes {
+    alignas(32) float xy[kEdgeLanes * 2U + 2U];
+
+    void store(__m256 x, __m256 y) noexcept {
+        const __m256 low  = _mm256_unpacklo_ps(x, y);   // lanes 0 1 | 4 5
+        const __m256 high = _mm256_unpackhi_ps(x, y);   // lanes 2 3 | 6 7
+        _mm256_store_ps(xy,     _mm256_permute2f128_ps(low, high, 0x20));
+        _mm256_store_ps(xy + 8, _mm256_permute2f128_ps(low, high, 0x31));
+    }
+
+    [[nodiscard]] __m128 at(std::size_t lane) const noexcept {
+        return _mm_loadu_ps(xy + lane * 2U);            // x, y in the low half
+    }
+};
+
+// two Vertex values, 12 floats, as three 16 byte stores; streamed when `dst` is aligned
+inline void storeVertexPair(float* dst, __m128 first, __m128 second, __m128 rgba, __m128 ba, bool stream) noexcept {
+    const __m128 q0 = _mm_movelh_ps(first, rgba);       // x y r g
+    const __m128 q1 = _mm_movelh_ps(ba, second);        // b a x y
+    if (stream) {
+        _mm_stream_ps(dst,     q0);
+        _mm_stream_ps(dst + 4, q1);
+        _mm_stream_ps(dst + 8, rgba);
+    } else {
+        _mm_storeu_ps(dst,     q0);
+        _mm_storeu_ps(dst + 4, q1);
+        _mm_storeu_ps(dst + 8, rgba);
+    }
+}
+
+// extrude the 8 edges a[k] -> b[k] into quads, 48 vertices from `out` on; matches
+// Renderer::extrudeEdge() except that the normal comes from rsqrt and one Newton step
+void extrudeEdges8(const FrameSnapshot& frame, const std::int32_t* a, const std::int32_t* b,
+                   float halfWidth, const Color& color, Vertex* out) noexcept {
+    const __m256i ia = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+    const __m256i ib = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+    const __m256  x1 = _mm256_i32gather_ps(frame.x.data(), ia, 4);
+    const __m256  y1 = _mm256_i32gather_ps(frame.y.data(), ia, 4);
+    const __m256  x2 = _mm256_i32gather_ps(frame.x.data(), ib, 4);
+    const __m256  y2 = _mm256_i32gather_ps(frame.y.data(), ib, 4);
+
+    const __m256 dx        = _mm256_sub_ps(x2, x1);
+    const __m256 dy        = _mm256_sub_ps(y2, y1);
+    const __m256 lengthSqr = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+
+    // rsqrt is good to 12 bits; one Newton step brings it close to 1 / sqrt
+    const __m256 estimate = _mm256_rsqrt_ps(lengthSqr);
+    const __m256 refined  = _mm256_mul_ps(
+        _mm256_mul_ps(_mm256_set1_ps(0.5f), estimate),
+        _mm256_sub_ps(_mm256_set1_ps(3.0f), _mm256_mul_ps(lengthSqr, _mm256_mul_ps(estimate, estimate))));
+    const __m256 scale = _mm256_mul_ps(refined, _mm256_set1_ps(halfWidth));
+    const __m256 nx    = _mm256_mul_ps(_mm256_sub_ps(_mm256_setzero_ps(), dy), scale);
+    const __m256 ny    = _mm256_mul_ps(dx, scale);
+
+    PointLanes r1, r2, r3, r4;
+    r1.store(_mm256_add_ps(x1, nx), _mm256_add_ps(y1, ny));
+    r2.store(_mm256_sub_ps(x1, nx), _mm256_sub_ps(y1, ny));
+    r3.store(_mm256_sub_ps(x2, nx), _mm256_sub_ps(y2, ny));
+    r4.store(_mm256_add_ps(x2, nx), _mm256_add_ps(y2, ny));
+
+    const __m128 rgba   = _mm_loadu_ps(color.data());
+    const __m128 ba     = _mm_movehl_ps(rgba, rgba);
+    float*       dst    = &out->x;
+    const bool   stream = reinterpret_cast<std::uintptr_t>(dst) % 16U == 0U;
+
+    // same order as the scalar path: r1 r2 r3, r4 r3 r1
+    for (std::size_t k = 0; k < kEdgeLanes; ++k, dst += 36) {
+        storeVertexPair(dst,      r1.at(k), r2.at(k), rgba, ba, stream);
+        storeVertexPair(dst + 12, r3.at(k), r4.at(k), rgba, ba, stream);
+        storeVertexPair(dst + 24, r3.at(k), r1.at(k), rgba, ba, stream);
+    }
+}
+
+#endif
+
+}  // namespace
+
 Renderer::Renderer(
     const Settings& settings,
     const float     screenWidth,
     const float     screenHeight
 )
     : program_(compileShaders(vertex_glsl, fragment_glsl))
+    , indexedMesh_(settings.indexedMesh)
+    , meshProgram_(compileShaders(mesh_vertex_glsl, mesh_geometry_glsl, fragment_glsl))
+    , pool_(renderThreads(settings) > 1 ? std::make_unique<ThreadPool>(renderThreads(settings)) : nullptr)
     , screenWidth_(screenWidth)
     , screenHeight_(screenHeight)
     , aspectRatio_(screenWidth / screenHeight)
 {
-    if (program_.id() == 0U) {
+    if (program_.id() == 0U || meshProgram_.id() == 0U) {
         throw std::runtime_error("Failed to compile shaders");
     }
 
@@ -53,32 +157,26 @@ void Renderer::initState(
 
     vao_.unbind();
 
-    aspectRatioLocation_       = glGetUniformLocation(program_.id(), "aspectRatio");
-    mousePosLocation_          = glGetUniformLocation(program_.id(), "mousePos");
-    mouseBarrierRadiusLocation_ = glGetUniformLocation(program_.id(), "mouseBarrierRadius");
-    displayBoundsLocation_     = glGetUniformLocation(program_.id(), "displayBounds");
-    mouseBarrierColorLocation_ = glGetUniformLocation(program_.id(), "mouseBarrierColor");
-    mouseBarrierBlurLocation_  = glGetUniformLocation(program_.id(), "mouseBarrierBlur");
-
-    glUseProgram(program_.id());
-    glUniform1f(aspectRatioLocation_, aspectRatio_);
-
-    const float mouseDistNDC = settings.barrier.radius * screenHeight / 2.0f;
-    glUniform1f(mouseBarrierRadiusLocation_, mouseDistNDC);
-    glUniform2f(displayBoundsLocation_, screenWidth, screenHeight);
-    glUniform1f(mouseBarrierBlurLocation_, settings.barrier.blur);
-
-    if (settings.barrier.draw) {
-        glUniform4f(
-            mouseBarrierColorLocation_,
-            settings.barrier.color[0],
-            settings.barrier.color[1],
-            settings.barrier.color[2],
-            settings.barrier.color[3]
-        );
-    } else {
-        glUniform4f(mouseBarrierColorLocation_, 0.0f, 0.0f, 0.0f, 0.0f);
-    }
+    // x and y are separate runs in one region; uploadMesh() points both attributes
+    // at the region it wrote
+    meshVao_.bind();
+    meshPositions_.bind();
+    glVertexAttribPointer(0, 1, GL_FLOAT, GL_FALSE, sizeof(float), nullptr);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(float), nullptr);
+    glEnableVertexAttribArray(1);
+    meshIndices_.bind();
+    meshVao_.unbind();
+
+    mousePosLocation_     = initProgramUniforms(program_.id(), settings, aspectRatio_, screenWidth, screenHeight);
+    meshMousePosLocation_ = initProgramUniforms(meshProgram_.id(), settings, aspectRatio_, screenWidth, screenHeight);
+
+    // the gradient never changes, so its stops go up once
+    gradientStops_.setData(settings.backGroundColors, GL_STATIC_DRAW);
+    glUseProgram(meshProgram_.id());
+    glUniform1i(glGetUniformLocation(meshProgram_.id(), "gradientStops"), 0);
+    glUniform1i(glGetUniformLocation(meshProgram_.id(), "gradientStopCount"),
+                static_cast<GLint>(settings.backGroundColors.size()));
     glUseProgram(0);
 
     if (settings.stars.draw) {
@@ -106,124 +204,213 @@ void Renderer::initState(
 
     halfEdgeWidth_ = settings.edges.width * 0.5f;
 
-    const size_t numberOfStarVertices =
-        settings.stars.draw ? static_cast<size_t>(settings.stars.count) * settings.stars.segments * 3 : 0;
-    const size_t numberOfLineVertices =
-        settings.edges.draw ? static_cast<size_t>(settings.stars.count) * 18 - 36 : 0;
-    const size_t numberOfTriangleVertices = static_cast<size_t>(settings.stars.count) * 6 - 15;
-
-    verticesCount = numberOfTriangleVertices + numberOfStarVertices + numberOfLineVertices;
+    // nothing is uploaded until the first simulation frame arrives
+    verticesCount  = 0;
+    meshDrawCount_ = 0;
 }
 
-void Renderer::rebuildStaticData(
-    const Settings&      settings,
-    const StarSystem&    starSystem,
-    std::vector<double>& coords,
-    std::vector<Vertex>& vertices)
+GLint Renderer::initProgramUniforms(
+    const GLuint    program,
+    const Settings& settings,
+    const float     aspectRatio,
+    const float     screenWidth,
+    const float     screenHeight)
 {
-    const int   starsCount   = settings.stars.count;
-    const bool  drawStars    = settings.stars.draw;
-    const bool  drawEdges    = settings.edges.draw;
-    const auto  starCountULL = static_cast<std::size_t>(starsCount);
-
-    const std::size_t starCoordCount = 2U * starCountULL;
-    coords.resize(starCoordCount);
-
-    for (std::size_t i = 0; i < starSystem.stars().size(); ++i) {
-        const std::size_t idx = 2U * i;
-        coords[idx]           = starSystem.stars()[i].getX();
-        coords[idx + 1U]      = starSystem.stars()[i].getY();
-    }
-
-    const std::size_t numberOfStarVertices =
-        drawStars ? starCountULL * static_cast<std::size_t>(settings.stars.segments) * 3U
-                  : 0U;
-
-    const std::size_t numberOfLineVertices = drawEdges ? starCountULL * 18U - 36U : 0U;
+    glUseProgram(program);
+    glUniform1f(glGetUniformLocation(program, "aspectRatio"), aspectRatio);
 
-    const std::size_t numberOfTriangleVertices = starCountULL * 6U - 15U;
+    const float mouseDistNDC = settings.barrier.radius * screenHeight / 2.0f;
+    glUniform1f(glGetUniformLocation(program, "mouseBarrierRadius"), mouseDistNDC);
+    glUniform2f(glGetUniformLocation(program, "displayBounds"), screenWidth, screenHeight);
+    glUniform1f(glGetUniformLocation(program, "mouseBarrierBlur"), settings.barrier.blur);
 
-    const std::size_t reserveCount =
-        numberOfTriangleVertices
-        + numberOfStarVertices
-        + numberOfLineVertices;
+    const GLint mouseBarrierColorLocation = glGetUniformLocation(program, "mouseBarrierColor");
+    if (settings.barrier.draw) {
+        glUniform4f(
+            mouseBarrierColorLocation,
+            settings.barrier.color[0],
+            settings.barrier.color[1],
+            settings.barrier.color[2],
+            settings.barrier.color[3]
+        );
+    } else {
+        glUniform4f(mouseBarrierColorLocation, 0.0f, 0.0f, 0.0f, 0.0f);
+    }
 
-    vertices.clear();
-    vertices.reserve(reserveCount);
+    const GLint mousePosLocation = glGetUniformLocation(program, "mousePos");
+    glUseProgram(0);
+    return mousePosLocation;
 }
 
 void Renderer::updateFrameGeometry(
-    const Settings&         settings,
-    const StarSystem&       starSystem,
-    const std::vector<double>& coords,
-    std::vector<Vertex>&    vertices,
-    delaunator::Delaunator& delaunator)
+    const Settings&      settings,
+    const FrameSnapshot& frame)
 {
-    vertices.clear();
-    insertTriangles(delaunator, vertices);
-    insertLines(settings, delaunator, vertices);
-    insertStars(settings, starSystem, vertices);
+    // the non-indexed mesh's corners go straight into the next positions region,
+    // every x and then every y; uploadMesh() points the attributes at it
+    if (!indexedMesh_) {
+        meshVertexCount_ = frame.triangles.size();
+        float* const positions = meshPositions_.map<float>(2U * meshVertexCount_);
+        if (positions != nullptr) {
+            float* const ys = positions + meshVertexCount_;
+            parallelFor(meshVertexCount_, kGeometryGrain, [&frame, positions, ys](std::size_t begin, std::size_t end) {
+                insertTriangles(frame, begin, end, positions, ys);
+            });
+        }
+        meshWritten_ = meshPositions_.unmap();
+    }
+
+    // only a halfedge chunk knows how many edges it draws, so count them first and
+    // turn the counts into each chunk's offset
+    const std::size_t halfedgeCount = settings.edges.draw ? frame.halfedges.size() : 0U;
+    const std::size_t lineChunks    = (halfedgeCount + kGeometryGrain - 1U) / kGeometryGrain;
+    const auto chunkEnd = [halfedgeCount](std::size_t chunk) {
+        return std::min((chunk + 1U) * kGeometryGrain, halfedgeCount);
+    };
+
+    lineOffsets_.assign(lineChunks + 1U, 0U);
+    parallelFor(lineChunks, 1U, [this, &frame, &chunkEnd](std::size_t begin, std::size_t end) {
+        for (std::size_t chunk = begin; chunk < end; ++chunk) {
+            std::size_t edges = 0;
+            for (std::size_t e = chunk * kGeometryGrain; e < chunkEnd(chunk); ++e) {
+                edges += drawsEdge(frame, e) ? 1U : 0U;
+            }
+            lineOffsets_[chunk + 1U] = edges * 6U;
+        }
+    });
+    std::partial_sum(lineOffsets_.begin(), lineOffsets_.end(), lineOffsets_.begin());
+
+    const std::size_t lineVertices    = lineOffsets_.back();
+    const std::size_t verticesPerStar =
+        settings.stars.draw ? static_cast<std::size_t>(settings.stars.segments) * 3U : 0U;
+    const std::size_t starVertices    = verticesPerStar == 0U ? 0U : frame.x.size() * verticesPerStar;
+
+    Vertex* const out = vbo_.map<Vertex>(lineVertices + starVertices);
+    if (out != nullptr) {
+        parallelFor(lineChunks, 1U, [this, &settings, &frame, &chunkEnd, out](std::size_t begin, std::size_t end) {
+            for (std::size_t chunk = begin; chunk < end; ++chunk) {
+                insertLines(settings, frame, chunk * kGeometryGrain, chunkEnd(chunk), out + lineOffsets_[chunk]);
+            }
+        });
+
+        Vertex* const stars = out + lineVertices;
+        if (starVertices > 0U) {
+            parallelFor(frame.x.size(), kGeometryGrain / verticesPerStar + 1U,
+                        [this, &settings, &frame, stars, verticesPerStar](std::size_t begin, std::size_t end) {
+                insertStars(settings, frame, begin, end, stars + begin * verticesPerStar);
+            });
+        }
+    }
+
+    // draw what was written; the hull size changes the edge count every frame
+    verticesCount = vbo_.unmap() ? lineVertices + starVertices : 0U;
+    firstVertex_  = vbo_.first<Vertex>();
 }
 
-void Renderer::uploadVertices(const std::vector<Vertex>& vertices) noexcept {
-    vbo_.setData(vertices, GL_DYNAMIC_DRAW);
+void Renderer::uploadMesh(const FrameSnapshot& frame) noexcept {
+    meshVao_.bind();
+    if (indexedMesh_) {
+        meshVertexCount_ = frame.x.size();
+        float* const positions = meshPositions_.map<float>(2U * meshVertexCount_);
+        if (positions != nullptr) {
+            std::copy(frame.x.begin(), frame.x.end(), positions);
+            std::copy(frame.y.begin(), frame.y.end(), positions + meshVertexCount_);
+        }
+        meshWritten_ = meshPositions_.unmap();
+
+        // the element buffer binding is part of meshVao_, which is still bound
+        std::uint32_t* const indices = meshIndices_.map<std::uint32_t>(frame.triangles.size());
+        if (indices != nullptr) {
+            std::copy(frame.triangles.begin(), frame.triangles.end(), indices);
+        }
+        meshWritten_    = meshIndices_.unmap() && meshWritten_;
+        meshFirstIndex_ = meshIndices_.first<std::uint32_t>();
+    } else {
+        // updateFrameGeometry() wrote the corners
+        meshPositions_.bind();
+    }
+
+    // the region moves every frame, so both attributes are pointed at it again
+    const auto xOffset = static_cast<std::size_t>(meshPositions_.first<float>()) * sizeof(float);
+    glVertexAttribPointer(0, 1, GL_FLOAT, GL_FALSE, sizeof(float), std::bit_cast<void*>(xOffset));
+    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(float),
+                          std::bit_cast<void*>(xOffset + meshVertexCount_ * sizeof(float)));
+    meshVao_.unbind();
+
+    meshDrawCount_ = !meshWritten_ ? 0U : indexedMesh_ ? frame.triangles.size() : meshVertexCount_;
 }
 
-void Renderer::render(const float mouseX, const float mouseY) const noexcept {
+void Renderer::render(const float mouseX, const float mouseY) noexcept {
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
 
+    if (meshDrawCount_ > 0U) {
+        glUseProgram(meshProgram_.id());
+        glUniform2f(meshMousePosLocation_, mouseX, mouseY);
+        gradientStops_.bind(0U);
+
+        meshVao_.bind();
+        if (indexedMesh_) {
+            const auto indexOffset = static_cast<std::size_t>(meshFirstIndex_) * sizeof(std::uint32_t);
+            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(meshDrawCount_), GL_UNSIGNED_INT,
+                           std::bit_cast<void*>(indexOffset));
+            meshIndices_.fence();
+        } else {
+            glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(meshDrawCount_));
+        }
+        meshVao_.unbind();
+        meshPositions_.fence();
+    }
+
     glUseProgram(program_.id());
     glUniform2f(mousePosLocation_, mouseX, mouseY);
 
     vao_.bind();
 
-    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(verticesCount)); // verticesCount supplied by caller or cached
+    glDrawArrays(GL_TRIANGLES, firstVertex_, static_cast<GLsizei>(verticesCount));
     vao_.unbind();
+    vbo_.fence();
 
     glUseProgram(0);
 }
 
-void Renderer::insertTriangles(
-    delaunator::Delaunator& d,
-    std::vector<Vertex>&    vertices) const
+void Renderer::parallelFor(
+    const std::size_t               count,
+    const std::size_t               grain,
+    const ThreadPool::RangeFunc&    func)
 {
-    for (std::size_t i = 0; i < d.triangles.size(); i += 3U) {
-        const std::size_t aIdx = 2U * d.triangles[i];
-        const std::size_t bIdx = 2U * d.triangles[i + 1U];
-        const std::size_t cIdx = 2U * d.triangles[i + 2U];
-
-        const float x1 = static_cast<float>(d.coords[aIdx]);
-        const float y1 = static_cast<float>(d.coords[aIdx + 1U]);
-        const float x2 = static_cast<float>(d.coords[bIdx]);
-        const float y2 = static_cast<float>(d.coords[bIdx + 1U]);
-        const float x3 = static_cast<float>(d.coords[cIdx]);
-        const float y3 = static_cast<float>(d.coords[cIdx + 1U]);
-
-        float cy = (y1 + y2 + y3) / 3.0f;
-        cy       = (cy + 1.0f) * 0.5f;
-
-        const Color color = interpolate(cy);
-
-        vertices.emplace_back(x1, y1, color);
-        vertices.emplace_back(x2, y2, color);
-        vertices.emplace_back(x3, y3, color);
+    if (!pool_) {
+        func(0, count);
+    } else {
+        pool_->parallelFor(count, grain, func);
     }
 }
 
-void Renderer::insertStars(
-    const Settings&   settings,
-    const StarSystem& starSystem,
-    std::vector<Vertex>& vertices) const
+void Renderer::insertTriangles(
+    const FrameSnapshot& frame,
+    const std::size_t    begin,
+    const std::size_t    end,
+    float*               xs,
+    float*               ys)
 {
-    if (!settings.stars.draw) {
-        return;
+    for (std::size_t k = begin; k < end; ++k) {
+        const std::uint32_t corner = frame.triangles[k];
+        xs[k] = frame.x[corner];
+        ys[k] = frame.y[corner];
     }
+}
 
+void Renderer::insertStars(
+    const Settings&      settings,
+    const FrameSnapshot& frame,
+    const std::size_t    begin,
+    const std::size_t    end,
+    Vertex*              out) const
+{
     const int segs = settings.stars.segments;
-    for (const Star& star : starSystem.stars()) {
-        const float centerX = star.getX();
-        const float centerY = star.getY();
+    for (std::size_t i = begin; i < end; ++i) {
+        const float centerX = frame.x[i];
+        const float centerY = frame.y[i];
 
         for (int j = 0; j < segs; ++j) {
             const int j1         = (j + 1) % segs;
@@ -235,60 +422,105 @@ void Renderer::insertStars(
             const float correctedX1 = centerX + xAspectRatioCorrectionValues_[jj];
             const float correctedX2 = centerX + xAspectRatioCorrectionValues_[jj1];
 
-            vertices.emplace_back(centerX,     centerY, settings.stars.color);
-            vertices.emplace_back(correctedX1, y1,      settings.stars.color);
-            vertices.emplace_back(correctedX2, y2,      settings.stars.color);
+            *out++ = Vertex(centerX,     centerY, settings.stars.color);
+            *out++ = Vertex(correctedX1, y1,      settings.stars.color);
+            *out++ = Vertex(correctedX2, y2,      settings.stars.color);
         }
     }
 }
 
 void Renderer::insertLines(
-    const Settings&   settings,
-    delaunator::Delaunator& d,
-    std::vector<Vertex>&    vertices) const
+    const Settings&      settings,
+    const FrameSnapshot& frame,
+    const std::size_t    begin,
+    const std::size_t    end,
+    Vertex*              out) const
 {
-    if (!settings.edges.draw) {
-        return;
+    const std::vector<std::uint32_t>& triangles = frame.triangles;
+
+#if defined(__AVX2__)
+    // compact the drawn edges into batches of 8; a partial batch is left for the scalar path
+    alignas(32) std::int32_t batchA[kEdgeLanes];
+    alignas(32) std::int32_t batchB[kEdgeLanes];
+    std::size_t batched = 0;
+
+    for (std::size_t i = begin; i < end; ++i) {
+        if (!drawsEdge(frame, i)) {
+            continue;
+        }
+
+        batchA[batched] = static_cast<std::int32_t>(triangles[i]);
+        batchB[batched] = static_cast<std::int32_t>(triangles[nextHalfedge(i)]);
+        if (++batched == kEdgeLanes) {
+            extrudeEdges8(frame, batchA, batchB, halfEdgeWidth_, settings.edges.color, out);
+            out    += kEdgeLanes * 6U;
+            batched = 0;
+        }
     }
 
-    for (std::size_t i = 0; i < d.halfedges.size(); ++i) {
-        const std::size_t j = d.halfedges[i];
-        if (j != delaunator::INVALID_INDEX && i < j) {
-            const std::size_t ia = 2U * d.triangles[i];
-            const std::size_t ib = 2U * d.triangles[nextHalfedge(i)];
-
-            const float x1 = static_cast<float>(d.coords[ia]);
-            const float y1 = static_cast<float>(d.coords[ia + 1U]);
-            const float x2 = static_cast<float>(d.coords[ib]);
-            const float y2 = static_cast<float>(d.coords[ib + 1U]);
-
-            const float dx        = x2 - x1;
-            const float dy        = y2 - y1;
-            const float lengthSqr = dx * dx + dy * dy;
-
-            if (lengthSqr != 0.0f) {
-                const float length = std::sqrt(lengthSqr);
-                const float nx     = -dy / length;
-                const float ny     = dx / length;
-
-                const float rx1 = x1 + nx * halfEdgeWidth_;
-                const float ry1 = y1 + ny * halfEdgeWidth_;
-                const float rx2 = x1 - nx * halfEdgeWidth_;
-                const float ry2 = y1 - ny * halfEdgeWidth_;
-                const float rx3 = x2 - nx * halfEdgeWidth_;
-                const float ry3 = y2 - ny * halfEdgeWidth_;
-                const float rx4 = x2 + nx * halfEdgeWidth_;
-                const float ry4 = y2 + ny * halfEdgeWidth_;
-
-                vertices.emplace_back(rx1, ry1, settings.edges.color);
-                vertices.emplace_back(rx2, ry2, settings.edges.color);
-                vertices.emplace_back(rx3, ry3, settings.edges.color);
-                vertices.emplace_back(rx4, ry4, settings.edges.color);
-                vertices.emplace_back(rx3, ry3, settings.edges.color);
-                vertices.emplace_back(rx1, ry1, settings.edges.color);
-            }
+    for (std::size_t k = 0; k < batched; ++k) {
+        out = extrudeEdge(frame, static_cast<std::size_t>(batchA[k]), static_cast<std::size_t>(batchB[k]),
+                          settings.edges.color, out);
+    }
+
+    // the streaming stores must land before the caller unmaps the buffer
+    _mm_sfence();
+#else
+    for (std::size_t i = begin; i < end; ++i) {
+        if (drawsEdge(frame, i)) {
+            out = extrudeEdge(frame, triangles[i], triangles[nextHalfedge(i)], settings.edges.color, out);
         }
     }
+#endif
+}
+
+Vertex* Renderer::extrudeEdge(
+    const FrameSnapshot& frame,
+    const std::size_t    a,
+    const std::size_t    b,
+    const Color&         color,
+    Vertex*              out) const
+{
+    const float x1 = frame.x[a];
+    const float y1 = frame.y[a];
+    const float x2 = frame.x[b];
+    const float y2 = frame.y[b];
+
+    const float dx     = x2 - x1;
+    const float dy     = y2 - y1;
+    const float length = std::sqrt(dx * dx + dy * dy);
+    const float nx     = -dy / length;
+    const float ny     = dx / length;
+
+    const float rx1 = x1 + nx * halfEdgeWidth_;
+    const float ry1 = y1 + ny * halfEdgeWidth_;
+    const float rx2 = x1 - nx * halfEdgeWidth_;
+    const float ry2 = y1 - ny * halfEdgeWidth_;
+    const float rx3 = x2 - nx * halfEdgeWidth_;
+    const float ry3 = y2 - ny * halfEdgeWidth_;
+    const float rx4 = x2 + nx * halfEdgeWidth_;
+    const float ry4 = y2 + ny * halfEdgeWidth_;
+
+    *out++ = Vertex(rx1, ry1, color);
+    *out++ = Vertex(rx2, ry2, color);
+    *out++ = Vertex(rx3, ry3, color);
+    *out++ = Vertex(rx4, ry4, color);
+    *out++ = Vertex(rx3, ry3, color);
+    *out++ = Vertex(rx1, ry1, color);
+    return out;
+}
+
+bool Renderer::drawsEdge(const FrameSnapshot& frame, const std::size_t e) noexcept {
+    const std::size_t opposite = frame.halfedges[e];
+    if (opposite == delaunator::Delaunator32::INVALID_INDEX || opposite < e) {
+        return false;
+    }
+
+    const std::size_t ia = frame.triangles[e];
+    const std::size_t ib = frame.triangles[nextHalfedge(e)];
+    const float dx = frame.x[ib] - frame.x[ia];
+    const float dy = frame.y[ib] - frame.y[ia];
+    return dx * dx + dy * dy != 0.0f;
 }
 
 std::size_t Renderer::nextHalfedge(const std::size_t e) noexcept {
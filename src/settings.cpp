@@ -147,6 +147,48 @@ void Settings::loadFromFile() {
                 "It must be greater than 0.");
         interaction.distanceFromMouse = ji["distance-from-mouse"];
 
+        if (!ji["sources"].is_array())
+            throw std::runtime_error(
+                "Invalid \"interaction.sources\" section.\n"
+                "It must be a list of sources.");
+
+        interaction.sources.clear();
+        for (const auto& jsrc : ji["sources"])
+        {
+            if (!jsrc.is_object() ||
+                !jsrc["position"].is_array() || jsrc["position"].size() != 2 ||
+                !jsrc["position"][0].is_number() || !jsrc["position"][1].is_number())
+                throw std::runtime_error(
+                    "Invalid source in \"interaction.sources\".\n"
+                    "Each source needs a \"position\" of exactly 2 numbers (X, Y).");
+
+            if (!jsrc["radius"].is_number() || jsrc["radius"] <= 0.0f)
+                throw std::runtime_error(
+                    "Invalid source \"radius\" in \"interaction.sources\".\n"
+                    "It must be greater than 0.");
+
+            if (!jsrc["strength"].is_number() || jsrc["strength"] < -1.0f || jsrc["strength"] > 1.0f)
+                throw std::runtime_error(
+                    "Invalid source \"strength\" in \"interaction.sources\".\n"
+                    "It must be between -1 (attract) and 1 (repel).");
+
+            const auto& falloff = jsrc["falloff"];
+            if (falloff != "hard" && falloff != "linear" && falloff != "smooth")
+                throw std::runtime_error(
+                    "Invalid source \"falloff\" in \"interaction.sources\".\n"
+                    "It must be \"hard\", \"linear\" or \"smooth\".");
+
+            InteractionSource source;
+            source.x        = jsrc["position"][0];
+            source.y        = jsrc["position"][1];
+            source.radius   = jsrc["radius"];
+            source.strength = jsrc["strength"];
+            source.falloff  = falloff == "hard"   ? Falloff::Hard
+                            : falloff == "linear" ? Falloff::Linear
+                                                  : Falloff::Smooth;
+            interaction.sources.push_back(source);
+        }
+
         // --- mouse-barrier ---
         auto& jb = j["mouse-barrier"];
 
@@ -174,6 +216,95 @@ void Settings::loadFromFile() {
                 "It must be greater than 0.");
         barrier.blur = jb["blur"];
 
+        // --- simulation ---
+        auto& jsim = j["simulation"];
+
+        if (!jsim["rate"].is_number() || jsim["rate"] <= 0.0f)
+            throw std::runtime_error(
+                "Invalid \"simulation.rate\" value.\n"
+                "Simulation steps per second must be greater than 0.");
+        simulation.rate = jsim["rate"];
+
+        if (!jsim["threads"].is_number_integer() || jsim["threads"] < 0)
+            throw std::runtime_error(
+                "Invalid \"simulation.threads\" value.\n"
+                "It must be 0 (all cores) or a positive whole number.");
+        simulation.threads = jsim["threads"];
+
+        if (!jsim["seed"].is_number_unsigned() || jsim["seed"] > 0xFFFFFFFFU)
+            throw std::runtime_error(
+                "Invalid \"simulation.seed\" value.\n"
+                "It must be 0 (a new seed every run) or a positive whole number.");
+        simulation.seed = jsim["seed"];
+
+        auto& jsep = jsim["separation"];
+
+        if (!jsep["distance"].is_number() || jsep["distance"] < 0.0f)
+            throw std::runtime_error(
+                "Invalid \"simulation.separation.distance\" value.\n"
+                "It must be 0 (off) or greater.");
+        simulation.separation = jsep["distance"];
+
+        if (!jsep["stiffness"].is_number() || jsep["stiffness"] <= 0.0f || jsep["stiffness"] > 1.0f)
+            throw std::runtime_error(
+                "Invalid \"simulation.separation.stiffness\" value.\n"
+                "It must be greater than 0 and at most 1.");
+        simulation.separationStiffness = jsep["stiffness"];
+
+        const auto& motion = jsim["motion"];
+        if (motion != "bounce" && motion != "flow")
+            throw std::runtime_error(
+                "Invalid \"simulation.motion\" value.\n"
+                "It must be \"bounce\" or \"flow\".");
+        simulation.motion = motion == "flow" ? Motion::Flow : Motion::Bounce;
+
+        auto& jflow = jsim["flow"];
+
+        if (!jflow["scale"].is_number() || jflow["scale"] <= 0.0f)
+            throw std::runtime_error(
+                "Invalid \"simulation.flow.scale\" value.\n"
+                "It must be greater than 0.");
+        simulation.flowScale = jflow["scale"];
+
+        if (!jflow["refresh"].is_number() || jflow["refresh"] <= 0.0f)
+            throw std::runtime_error(
+                "Invalid \"simulation.flow.refresh\" value.\n"
+                "It must be greater than 0.");
+        simulation.flowRefresh = jflow["refresh"];
+
+        auto& jtrace = jsim["trace"];
+
+        const auto& traceMode = jtrace["mode"];
+        if (traceMode != "off" && traceMode != "record" && traceMode != "replay")
+            throw std::runtime_error(
+                "Invalid \"simulation.trace.mode\" value.\n"
+                "It must be \"off\", \"record\" or \"replay\".");
+        simulation.traceMode = traceMode == "record" ? TraceMode::Record
+                             : traceMode == "replay" ? TraceMode::Replay
+                                                     : TraceMode::Off;
+
+        if (!jtrace["file"].is_string() ||
+            (simulation.traceMode != TraceMode::Off && jtrace["file"].get<std::string>().empty()))
+            throw std::runtime_error(
+                "Invalid \"simulation.trace.file\" value.\n"
+                "It must be the path of the trace to record or replay.");
+        simulation.traceFile = jtrace["file"];
+
+        // --- triangulation ---
+        auto& jt = j["triangulation"];
+
+        if (!jt["kinetic"].is_boolean())
+            throw std::runtime_error(
+                "Invalid \"triangulation.kinetic\" value.\n"
+                "This setting must be either true or false.");
+        triangulation.kinetic = jt["kinetic"];
+
+        if (!jt["threads"].is_number_integer() || jt["threads"] < 0)
+            throw std::runtime_error(
+                "Invalid \"triangulation.threads\" value.\n"
+                "It must be 0 (all cores) or a positive whole number.");
+        triangulation.threads = jt["threads"];
+
         // --- offset-bounds ---
         if (!j["offset-bounds"].is_number() || j["offset-bounds"] < 0.0f)
             throw std::runtime_error(
@@ -187,6 +318,20 @@ void Settings::loadFromFile() {
                 "Invalid \"MSAA\" value.\n"
                 "It must be 0 or a positive whole number.");
         MSAA = j["MSAA"];
+
+        // --- indexed-mesh ---
+        if (!j["indexed-mesh"].is_boolean())
+            throw std::runtime_error(
+                "Invalid \"indexed-mesh\" value.\n"
+                "This setting must be either true or false.");
+        indexedMesh = j["indexed-mesh"];
+
+        // --- render-threads ---
+        if (!j["render-threads"].is_number_integer() || j["render-threads"] < 0)
+            throw std::runtime_error(
+                "Invalid \"render-threads\" value.\n"
+                "It must be 0 or a positive whole number.");
+        renderThreads = j["render-threads"];
     }
     catch (const nlohmann::json::parse_error&)
     {
@@ -1,40 +1,37 @@
 #include <shader_utils.hpp>
 #include <fstream>
 #include <sstream>
+#include <initializer_list>
 #include <iostream>
 
 
 namespace delaunay_flow {
 
-GLuint compileShaders(const char* vertexCode, const char* fragmentCode) {
-    GLuint vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vertexCode, nullptr);
-    glCompileShader(vertex);
+namespace {
 
-    GLint success;
-    glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        char infoLog[512];
-        glGetShaderInfoLog(vertex, 512, nullptr, infoLog);
-        std::cerr << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
+GLuint compileStage(GLenum type, const char* code, const char* name) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &code, nullptr);
+    glCompileShader(shader);
 
-    GLuint fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fragmentCode, nullptr);
-    glCompileShader(fragment);
-
-    glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
+    GLint success;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
     if (!success) {
         char infoLog[512];
-        glGetShaderInfoLog(fragment, 512, nullptr, infoLog);
-        std::cerr << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+        glGetShaderInfoLog(shader, 512, nullptr, infoLog);
+        std::cerr << "ERROR::SHADER::" << name << "::COMPILATION_FAILED\n" << infoLog << std::endl;
     }
+    return shader;
+}
 
+GLuint linkProgram(std::initializer_list<GLuint> shaders) {
     GLuint program = glCreateProgram();
-    glAttachShader(program, vertex);
-    glAttachShader(program, fragment);
+    for (GLuint shader : shaders) {
+        glAttachShader(program, shader);
+    }
     glLinkProgram(program);
 
+    GLint success;
     glGetProgramiv(program, GL_LINK_STATUS, &success);
     if (!success) {
         char infoLog[512];
@@ -42,10 +39,27 @@ GLuint compileShaders(const char* vertexCode, const char* fragmentCode) {
         std::cerr << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
     }
 
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
-
+    for (GLuint shader : shaders) {
+        glDeleteShader(shader);
+    }
     return program;
 }
 
+}  // namespace
+
+GLuint compileShaders(const char* vertexCode, const char* fragmentCode) {
+    return linkProgram({
+        compileStage(GL_VERTEX_SHADER, vertexCode, "VERTEX"),
+        compileStage(GL_FRAGMENT_SHADER, fragmentCode, "FRAGMENT"),
+    });
+}
+
+GLuint compileShaders(const char* vertexCode, const char* geometryCode, const char* fragmentCode) {
+    return linkProgram({
+        compileStage(GL_VERTEX_SHADER, vertexCode, "VERTEX"),
+        compileStage(GL_GEOMETRY_SHADER, geometryCode, "GEOMETRY"),
+        compileStage(GL_FRAGMENT_SHADER, fragmentCode, "FRAGMENT"),
+    });
+}
+
 }  // namespace delaunay_flow
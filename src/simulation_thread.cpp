@@ -0,0 +1,114 @@
+#include <simulation_thread.hpp>
+
+#include <chrono>
+
+namespace delaunay_flow {
+
+SimulationThread::SimulationThread(const StarSystemParams& params, Rect bounds,
+                                   bool kinetic, std::size_t triangulationThreads,
+                                   TraceMode traceMode, const std::filesystem::path& traceFile)
+    : replay_(traceMode == TraceMode::Replay ? std::make_unique<TraceReader>(traceFile) : nullptr)
+    , starSystem_(replay_ ? starSystemParams(replay_->header(), params.threads) : params,
+                  replay_ ? replay_->header().bounds : bounds)
+    , recorder_(traceMode == TraceMode::Record
+                    ? std::make_unique<TraceWriter>(traceFile, traceHeader(starSystem_))
+                    : nullptr)
+    , kinetic_(kinetic)
+    , triangulationThreads_(triangulationThreads)
+    , worker_([this](std::stop_token stop) { run(stop); })
+{
+}
+
+SimulationThread::~SimulationThread() {
+    worker_.request_stop();
+    // take whatever is pending so a worker waiting for the reader wakes up and sees the stop
+    snapshots_.acquire();
+}
+
+bool SimulationThread::acquire() {
+    if (failed_.load(std::memory_order_acquire)) {
+        std::rethrow_exception(error_);
+    }
+    return snapshots_.acquire();
+}
+
+void SimulationThread::setSources(std::span<const InteractionSource> sources) {
+    std::vector<InteractionSource>& back = sources_.back();
+    back.assign(sources.begin(), sources.end());
+    sources_.publish();
+}
+
+void SimulationThread::requestReset() noexcept {
+    resetRequested_.store(true, std::memory_order_relaxed);
+}
+
+bool SimulationThread::nextFrame(TraceFrame& frame, std::chrono::steady_clock::time_point& previous) {
+    if (replay_) {
+        return replay_->next(frame);
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    frame.frameTime = std::chrono::duration<float>(now - previous).count();
+    previous        = now;
+
+    frame.reset = resetRequested_.exchange(false, std::memory_order_relaxed);
+
+    sources_.acquire();
+    frame.sources.assign(sources_.front().begin(), sources_.front().end());
+
+    if (recorder_) {
+        recorder_->write(frame);
+    }
+    return true;
+}
+
+void SimulationThread::run(const std::stop_token& stop) {
+    auto previous = std::chrono::steady_clock::now();
+    TraceFrame frame;
+
+    // an exception would terminate the process here; stop producing frames and
+    // let the render thread rethrow it from acquire() instead
+    try {
+        // a replay that runs out leaves its last frame on screen
+        while (!stop.stop_requested() && nextFrame(frame, previous)) {
+            if (frame.reset) {
+                starSystem_.reset();
+            }
+
+            starSystem_.advance(std::chrono::duration<float>(frame.frameTime), frame.sources);
+
+            const delaunator::point_view<float> points = starSystem_.positions();
+            if (kinetic_) {
+                delaunator_.repair(points, triangulationThreads_);
+            } else {
+                delaunator_.update(points, triangulationThreads_);
+            }
+            starSystem_.setNeighbors(delaunator_.triangles, delaunator_.halfedges);
+
+            publish();
+            snapshots_.waitForReader(stop);
+        }
+    } catch (const std::exception&) {
+        error_ = std::current_exception();
+        failed_.store(true, std::memory_order_release);
+    }
+}
+
+void SimulationThread::publish() {
+    FrameSnapshot& frame = snapshots_.back();
+    const delaunator::point_view<float> points = starSystem_.positions();
+
+    // each slot keeps its storage, so after the first few frames this doesn't allocate
+    frame.x.resize(points.size());
+    frame.y.resize(points.size());
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        frame.x[i] = points.x(i);
+        frame.y[i] = points.y(i);
+    }
+    frame.triangles.assign(delaunator_.triangles.begin(), delaunator_.triangles.end());
+    frame.halfedges.assign(delaunator_.halfedges.begin(), delaunator_.halfedges.end());
+
+    snapshots_.publish();
+}
+
+}  // namespace delaunay_flow
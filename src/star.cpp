@@ -1,77 +1,402 @@
 #include <star.hpp>
+#include <algorithm>
 #include <cmath>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 namespace delaunay_flow {
 
-Star::MoveFunc Star::moveFunc_ = nullptr;
-float Star::mouseXNDC = 0.0f;
-float Star::mouseYNDC = 0.0f;
-float Star::mouseKeepDistance = 0.0f;
+namespace {
+
+// --- Slight ellipse deformation of the interaction barriers ---
+constexpr float ellipseFactor = 1.015f;  // 1.0f = perfect circle
+
+// These scalar loops finish the last few stars of the AVX2 kernels below, which
+// round every multiply and add on its own. /fp:fast would let MSVC fuse them into
+// FMAs here, so the tails are compiled precise to round the same way as the lanes
+#if defined(_MSC_VER)
+#pragma float_control(precise, on, push)
+#pragma fp_contract(off)
+#endif
+
+float moveStarsScalar(Stars& s, const StarMotion& m, std::size_t begin, std::size_t end) noexcept {
+    const Rect& bounds = m.bounds;
+    float maxShift = 0.0f;
+
+    for (std::size_t i = begin; i < end; ++i) {
+        float orgx = s.orgx[i] + s.vx[i] * m.dt;
+        float orgy = s.orgy[i] + s.vy[i] * m.dt;
+
+        float x = s.x[i] + (orgx - s.x[i]) * m.dt;
+        float y = s.y[i] + (orgy - s.y[i]) * m.dt;
+
+        if (orgx <= bounds.left) {
+            s.vx[i] = std::abs(s.vx[i]);
+            orgx -= (orgx - bounds.left) * 2;
+        } else if (orgx >= bounds.right) {
+            s.vx[i] = -std::abs(s.vx[i]);
+            orgx -= (orgx - bounds.right) * 2;
+        }
+
+        if (orgy <= bounds.bottom) {
+            s.vy[i] = std::abs(s.vy[i]);
+            orgy -= (orgy - bounds.bottom) * 2;
+        } else if (orgy >= bounds.top) {
+            s.vy[i] = -std::abs(s.vy[i]);
+            orgy -= (orgy - bounds.top) * 2;
+        }
+
+        maxShift = std::max({ maxShift, std::abs(x - s.x[i]), std::abs(y - s.y[i]) });
+
+        s.orgx[i] = orgx;
+        s.orgy[i] = orgy;
+        s.x[i]    = x;
+        s.y[i]    = y;
+    }
+
+    return maxShift;
+}
+
+// Bilinear sample of both flow tables at (x, y), mixed by the cross-fade; points
+// off the table read its edge. The AVX2 kernel below does the same arithmetic in
+// the same order
+void sampleFlow(const FlowTable& flow, float x, float y, float& fx, float& fy) noexcept {
+    const float gx = std::clamp((x - flow.left) * flow.invSpacing, 0.0f, static_cast<float>(flow.columns - 1));
+    const float gy = std::clamp((y - flow.bottom) * flow.invSpacing, 0.0f, static_cast<float>(flow.rows - 1));
+
+    const int   col = std::min(static_cast<int>(gx), flow.columns - 2);
+    const int   row = std::min(static_cast<int>(gy), flow.rows - 2);
+    const float tx  = gx - static_cast<float>(col);
+    const float ty  = gy - static_cast<float>(row);
+
+    const std::size_t i00 = static_cast<std::size_t>(row) * static_cast<std::size_t>(flow.columns) + static_cast<std::size_t>(col);
+    const std::size_t i01 = i00 + static_cast<std::size_t>(flow.columns);
+
+    const auto bilinear = [=](const float* v) {
+        const float bottom = v[i00] + (v[i00 + 1] - v[i00]) * tx;
+        const float top    = v[i01] + (v[i01 + 1] - v[i01]) * tx;
+        return bottom + (top - bottom) * ty;
+    };
+    const float fromX = bilinear(flow.fromX);
+    const float fromY = bilinear(flow.fromY);
+    fx = fromX + (bilinear(flow.toX) - fromX) * flow.blend;
+    fy = fromY + (bilinear(flow.toY) - fromY) * flow.blend;
+}
+
+float moveStarsFlowScalar(Stars& s, const StarMotion& m, const FlowTable& flow,
+                          std::size_t begin, std::size_t end) noexcept {
+    const Rect& bounds = m.bounds;
+    float maxShift = 0.0f;
+
+    for (std::size_t i = begin; i < end; ++i) {
+        const float speed = std::sqrt(s.vx[i] * s.vx[i] + s.vy[i] * s.vy[i]);
+
+        float fx = 0.0f;
+        float fy = 0.0f;
+        sampleFlow(flow, s.orgx[i], s.orgy[i], fx, fy);
+
+        const float orgx = std::clamp(s.orgx[i] + fx * speed * m.dt, bounds.left, bounds.right);
+        const float orgy = std::clamp(s.orgy[i] + fy * speed * m.dt, bounds.bottom, bounds.top);
+
+        const float x = s.x[i] + (orgx - s.x[i]) * m.dt;
+        const float y = s.y[i] + (orgy - s.y[i]) * m.dt;
+
+        maxShift = std::max({ maxShift, std::abs(x - s.x[i]), std::abs(y - s.y[i]) });
+
+        s.orgx[i] = orgx;
+        s.orgy[i] = orgy;
+        s.x[i]    = x;
+        s.y[i]    = y;
+    }
+
+    return maxShift;
+}
+
+#if defined(_MSC_VER)
+#pragma float_control(pop)
+#pragma fp_contract(on)
+#endif
+
+#if defined(__AVX2__)
+
+// largest of the 8 lanes
+inline float horizontalMax(__m256 v) noexcept {
+    __m128 v4 = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    v4 = _mm_max_ps(v4, _mm_movehl_ps(v4, v4));
+    v4 = _mm_max_ss(v4, _mm_shuffle_ps(v4, v4, 1));
+    return _mm_cvtss_f32(v4);
+}
+
+inline __m256 lerp(__m256 a, __m256 b, __m256 t) noexcept {
+    return _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), t));
+}
+
+// bilinear gather from one table component; i00 indexes each lane's lower left sample
+inline __m256 gatherBilinear(const float* v, __m256i i00, __m256i i01, __m256 tx, __m256 ty) noexcept {
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256 bottom = lerp(_mm256_i32gather_ps(v, i00, 4), _mm256_i32gather_ps(v, _mm256_add_epi32(i00, one), 4), tx);
+    const __m256 top    = lerp(_mm256_i32gather_ps(v, i01, 4), _mm256_i32gather_ps(v, _mm256_add_epi32(i01, one), 4), tx);
+    return lerp(bottom, top, ty);
+}
+
+float moveStarsFlowAvx2(Stars& s, const StarMotion& m, const FlowTable& flow,
+                        std::size_t begin, std::size_t end) noexcept {
+    const __m256  dt         = _mm256_set1_ps(m.dt);
+    const __m256  left       = _mm256_set1_ps(m.bounds.left);
+    const __m256  right      = _mm256_set1_ps(m.bounds.right);
+    const __m256  bottom     = _mm256_set1_ps(m.bounds.bottom);
+    const __m256  top        = _mm256_set1_ps(m.bounds.top);
+    const __m256  flowLeft   = _mm256_set1_ps(flow.left);
+    const __m256  flowBottom = _mm256_set1_ps(flow.bottom);
+    const __m256  invSpacing = _mm256_set1_ps(flow.invSpacing);
+    const __m256  blend      = _mm256_set1_ps(flow.blend);
+    const __m256  zero       = _mm256_setzero_ps();
+    const __m256  lastColumn = _mm256_set1_ps(static_cast<float>(flow.columns - 1));
+    const __m256  lastRow    = _mm256_set1_ps(static_cast<float>(flow.rows - 1));
+    const __m256i maxColumn  = _mm256_set1_epi32(flow.columns - 2);
+    const __m256i maxRow     = _mm256_set1_epi32(flow.rows - 2);
+    const __m256i columns    = _mm256_set1_epi32(flow.columns);
+    const __m256  signBit    = _mm256_set1_ps(-0.0f);
+
+    __m256 maxShift = _mm256_setzero_ps();
+
+    std::size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 orgx = _mm256_loadu_ps(&s.orgx[i]);
+        __m256 orgy = _mm256_loadu_ps(&s.orgy[i]);
+        const __m256 vx   = _mm256_loadu_ps(&s.vx[i]);
+        const __m256 vy   = _mm256_loadu_ps(&s.vy[i]);
+        const __m256 oldX = _mm256_loadu_ps(&s.x[i]);
+        const __m256 oldY = _mm256_loadu_ps(&s.y[i]);
 
-Star::Star(float x, float y, float speed, float angle)
-    : orgx_(x), orgy_(y), x_(x), y_(y),
-      speedx_(std::cosf(angle) * speed),
-      speedy_(std::sinf(angle) * speed) {}
+        const __m256 speed = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)));
 
-void Star::move(float dt, Rect bounds) noexcept {
-    (this->*moveFunc_)(dt, bounds);
+        const __m256 gx = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_sub_ps(orgx, flowLeft), invSpacing), zero), lastColumn);
+        const __m256 gy = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_sub_ps(orgy, flowBottom), invSpacing), zero), lastRow);
+
+        const __m256i col = _mm256_min_epi32(_mm256_cvttps_epi32(gx), maxColumn);
+        const __m256i row = _mm256_min_epi32(_mm256_cvttps_epi32(gy), maxRow);
+        const __m256  tx  = _mm256_sub_ps(gx, _mm256_cvtepi32_ps(col));
+        const __m256  ty  = _mm256_sub_ps(gy, _mm256_cvtepi32_ps(row));
+
+        const __m256i i00 = _mm256_add_epi32(_mm256_mullo_epi32(row, columns), col);
+        const __m256i i01 = _mm256_add_epi32(i00, columns);
+
+        const __m256 fx = lerp(gatherBilinear(flow.fromX, i00, i01, tx, ty), gatherBilinear(flow.toX, i00, i01, tx, ty), blend);
+        const __m256 fy = lerp(gatherBilinear(flow.fromY, i00, i01, tx, ty), gatherBilinear(flow.toY, i00, i01, tx, ty), blend);
+
+        orgx = _mm256_add_ps(orgx, _mm256_mul_ps(_mm256_mul_ps(fx, speed), dt));
+        orgy = _mm256_add_ps(orgy, _mm256_mul_ps(_mm256_mul_ps(fy, speed), dt));
+        orgx = _mm256_min_ps(_mm256_max_ps(orgx, left), right);
+        orgy = _mm256_min_ps(_mm256_max_ps(orgy, bottom), top);
+
+        const __m256 x = _mm256_add_ps(oldX, _mm256_mul_ps(_mm256_sub_ps(orgx, oldX), dt));
+        const __m256 y = _mm256_add_ps(oldY, _mm256_mul_ps(_mm256_sub_ps(orgy, oldY), dt));
+
+        maxShift = _mm256_max_ps(maxShift, _mm256_andnot_ps(signBit, _mm256_sub_ps(x, oldX)));
+        maxShift = _mm256_max_ps(maxShift, _mm256_andnot_ps(signBit, _mm256_sub_ps(y, oldY)));
+
+        _mm256_storeu_ps(&s.orgx[i], orgx);
+        _mm256_storeu_ps(&s.orgy[i], orgy);
+        _mm256_storeu_ps(&s.x[i], x);
+        _mm256_storeu_ps(&s.y[i], y);
+    }
+
+    return std::max(horizontalMax(maxShift), moveStarsFlowScalar(s, m, flow, i, end));
+}
+
+// One axis of the bounce: below `low` the speed turns positive and the origin is
+// mirrored back inside, above `high` the same in the other direction
+inline void reflect(__m256& org, __m256& v, __m256 low, __m256 high) noexcept {
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+    const __m256 two     = _mm256_set1_ps(2.0f);
+
+    const __m256 below = _mm256_cmp_ps(org, low, _CMP_LE_OQ);
+    const __m256 above = _mm256_andnot_ps(below, _mm256_cmp_ps(org, high, _CMP_GE_OQ));
+
+    const __m256 absV = _mm256_andnot_ps(signBit, v);
+    v = _mm256_blendv_ps(v, absV, below);
+    v = _mm256_blendv_ps(v, _mm256_or_ps(absV, signBit), above);
+
+    const __m256 wall = _mm256_blendv_ps(high, low, below);
+    const __m256 fixedOrg = _mm256_sub_ps(org, _mm256_mul_ps(_mm256_sub_ps(org, wall), two));
+    org = _mm256_blendv_ps(org, fixedOrg, _mm256_or_ps(below, above));
 }
 
-void Star::normalMove(float dt, Rect bounds) noexcept {
-    orgx_ += speedx_ * dt;
-    orgy_ += speedy_ * dt;
+float moveStarsAvx2(Stars& s, const StarMotion& m, std::size_t begin, std::size_t end) noexcept {
+    const __m256 dt      = _mm256_set1_ps(m.dt);
+    const __m256 left    = _mm256_set1_ps(m.bounds.left);
+    const __m256 right   = _mm256_set1_ps(m.bounds.right);
+    const __m256 bottom  = _mm256_set1_ps(m.bounds.bottom);
+    const __m256 top     = _mm256_set1_ps(m.bounds.top);
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+
+    __m256 maxShift = _mm256_setzero_ps();
 
-    float xdis = orgx_ - x_;
-    float ydis = orgy_ - y_;
+    std::size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 orgx = _mm256_loadu_ps(&s.orgx[i]);
+        __m256 orgy = _mm256_loadu_ps(&s.orgy[i]);
+        __m256 vx   = _mm256_loadu_ps(&s.vx[i]);
+        __m256 vy   = _mm256_loadu_ps(&s.vy[i]);
+        const __m256 oldX = _mm256_loadu_ps(&s.x[i]);
+        const __m256 oldY = _mm256_loadu_ps(&s.y[i]);
 
-    x_ += xdis * dt;
-    y_ += ydis * dt;
+        orgx = _mm256_add_ps(orgx, _mm256_mul_ps(vx, dt));
+        orgy = _mm256_add_ps(orgy, _mm256_mul_ps(vy, dt));
 
-    if (orgx_ <= bounds.left) {
-        speedx_ = std::abs(speedx_);
-        orgx_ -= (orgx_ - bounds.left) * 2;
-    } else if (orgx_ >= bounds.right) {
-        speedx_ = -std::abs(speedx_);
-        orgx_ -= (orgx_ - bounds.right) * 2;
+        const __m256 x = _mm256_add_ps(oldX, _mm256_mul_ps(_mm256_sub_ps(orgx, oldX), dt));
+        const __m256 y = _mm256_add_ps(oldY, _mm256_mul_ps(_mm256_sub_ps(orgy, oldY), dt));
+
+        reflect(orgx, vx, left, right);
+        reflect(orgy, vy, bottom, top);
+
+        maxShift = _mm256_max_ps(maxShift, _mm256_andnot_ps(signBit, _mm256_sub_ps(x, oldX)));
+        maxShift = _mm256_max_ps(maxShift, _mm256_andnot_ps(signBit, _mm256_sub_ps(y, oldY)));
+
+        _mm256_storeu_ps(&s.orgx[i], orgx);
+        _mm256_storeu_ps(&s.orgy[i], orgy);
+        _mm256_storeu_ps(&s.vx[i], vx);
+        _mm256_storeu_ps(&s.vy[i], vy);
+        _mm256_storeu_ps(&s.x[i], x);
+        _mm256_storeu_ps(&s.y[i], y);
     }
 
-    if (orgy_ <= bounds.bottom) {
-        speedy_ = std::abs(speedy_);
-        orgy_ -= (orgy_ - bounds.bottom) * 2;
-    } else if (orgy_ >= bounds.top) {
-        speedy_ = -std::abs(speedy_);
-        orgy_ -= (orgy_ - bounds.top) * 2;
+    return std::max(horizontalMax(maxShift), moveStarsScalar(s, m, i, end));
+}
+
+#endif
+
+// One axis of fastForwardStars(). With e = org - x, a step maps e to
+// (e + v * dt) * (1 - dt), which settles at v * (1 - dt); both points are tracked
+// on the unfolded line and then folded into [low, high] by the same mirror the
+// bounce applies. Doubles keep hours of travel exact enough.
+void fastForwardAxis(float& pos, float& org, float& v, float dt, double decay, std::uint64_t steps,
+                     float low, float high) noexcept {
+    const double width  = static_cast<double>(high) - low;
+    const double settle = static_cast<double>(v) * (1.0 - dt);
+    const double lag    = settle + (static_cast<double>(org) - pos - settle) * decay;
+
+    const double unfoldedOrg = org + static_cast<double>(v) * dt * static_cast<double>(steps);
+    const double unfoldedPos = unfoldedOrg - lag;
+
+    // how far along one trip there and back a point is; past `width` it is on the way back
+    const auto phase = [low, width](double u) {
+        const double p = std::fmod(u - low, 2.0 * width);
+        return p < 0.0 ? p + 2.0 * width : p;
+    };
+    const auto fold = [low, width](double p) {
+        return static_cast<float>(low + (p > width ? 2.0 * width - p : p));
+    };
+
+    const double orgPhase = phase(unfoldedOrg);
+    org = fold(orgPhase);
+    pos = fold(phase(unfoldedPos));
+    if (orgPhase > width) {
+        v = -v;
     }
 }
 
-void Star::moveWithMouse(float dt, Rect bounds) noexcept {
-    normalMove(dt, bounds);
+}  // namespace
+
+void Stars::clear() noexcept {
+    x.clear();
+    y.clear();
+    orgx.clear();
+    orgy.clear();
+    vx.clear();
+    vy.clear();
+}
 
-    float mouseDistanceX = Star::mouseXNDC - getX();
-    float mouseDistanceY = Star::mouseYNDC - getY();
+void Stars::reserve(std::size_t count) {
+    x.reserve(count);
+    y.reserve(count);
+    orgx.reserve(count);
+    orgy.reserve(count);
+    vx.reserve(count);
+    vy.reserve(count);
+}
 
-    // --- Slight ellipse deformation ---
-    constexpr float ellipseFactor = 1.015f;  // 1.0f = perfect circle
+void Stars::add(float startX, float startY, float speed, float angle) {
+    x.push_back(startX);
+    y.push_back(startY);
+    orgx.push_back(startX);
+    orgy.push_back(startY);
+    vx.push_back(std::cos(angle) * speed);
+    vy.push_back(std::sin(angle) * speed);
+}
 
-    float scaledX = mouseDistanceX * ellipseFactor;
-    float scaledY = mouseDistanceY;
+float applySource(Stars& stars, std::size_t i, const InteractionSource& source) noexcept {
+    const float x = stars.x[i];
+    const float y = stars.y[i];
 
-    float mouseDisSqr = scaledX * scaledX + scaledY * scaledY;
+    const float sourceDistanceX = source.x - x;
+    const float sourceDistanceY = source.y - y;
 
-    if (mouseDisSqr != 0.0f && mouseDisSqr < Star::mouseKeepDistance * Star::mouseKeepDistance) {
+    const float scaledX = sourceDistanceX * ellipseFactor;
+    const float scaledY = sourceDistanceY;
 
-        float ratio = Star::mouseKeepDistance / std::sqrt(mouseDisSqr);
+    const float disSqr = scaledX * scaledX + scaledY * scaledY;
 
-        x_ = mouseDistanceX + x_ - (mouseDistanceX * ratio);
-        y_ = mouseDistanceY + y_ - (mouseDistanceY * ratio);
+    if (disSqr == 0.0f || disSqr >= source.radius * source.radius) {
+        return 0.0f;
     }
+
+    const float distance = std::sqrt(disSqr);
+    const float t        = distance / source.radius;
+
+    float weight = 1.0f;
+    switch (source.falloff) {
+    case Falloff::Hard:
+        break;
+    case Falloff::Linear:
+        weight = 1.0f - t;
+        break;
+    case Falloff::Smooth:
+        weight = (1.0f - t * t) * (1.0f - t * t);
+        break;
+    }
+
+    // where the star ends up: pushed toward the edge or pulled toward the center
+    const float amount = source.strength * weight;
+    const float target = amount >= 0.0f
+        ? distance + amount * (source.radius - distance)
+        : distance + amount * distance;
+    const float ratio = target / distance;
+
+    stars.x[i] = sourceDistanceX + x - (sourceDistanceX * ratio);
+    stars.y[i] = sourceDistanceY + y - (sourceDistanceY * ratio);
+
+    return std::max(std::abs(stars.x[i] - x), std::abs(stars.y[i] - y));
 }
 
-void Star::init(bool moveFromMouse) noexcept {
-    if (moveFromMouse) {
-        moveFunc_ = &Star::moveWithMouse;
-    } else {
-        moveFunc_ = &Star::normalMove;
+float moveStars(Stars& stars, const StarMotion& motion, std::size_t begin, std::size_t end) noexcept {
+#if defined(__AVX2__)
+    return moveStarsAvx2(stars, motion, begin, end);
+#else
+    return moveStarsScalar(stars, motion, begin, end);
+#endif
+}
+
+float moveStarsFlow(Stars& stars, const StarMotion& motion, const FlowTable& flow,
+                    std::size_t begin, std::size_t end) noexcept {
+#if defined(__AVX2__)
+    return moveStarsFlowAvx2(stars, motion, flow, begin, end);
+#else
+    return moveStarsFlowScalar(stars, motion, flow, begin, end);
+#endif
+}
+
+void fastForwardStars(Stars& stars, const StarMotion& motion, std::uint64_t steps,
+                      std::size_t begin, std::size_t end) noexcept {
+    const Rect&  bounds = motion.bounds;
+    const double decay  = std::pow(1.0 - motion.dt, static_cast<double>(steps));
+
+    for (std::size_t i = begin; i < end; ++i) {
+        fastForwardAxis(stars.x[i], stars.orgx[i], stars.vx[i], motion.dt, decay, steps, bounds.left, bounds.right);
+        fastForwardAxis(stars.y[i], stars.orgy[i], stars.vy[i], motion.dt, decay, steps, bounds.bottom, bounds.top);
     }
 }
 
@@ -0,0 +1,56 @@
+#include <star_grid.hpp>
+
+#include <cmath>
+
+namespace delaunay_flow {
+
+namespace {
+
+// caps the grid at 256 x 256 cells however small the cell size gets
+constexpr int kMaxCellsPerAxis = 256;
+
+}  // namespace
+
+void StarGrid::rebuild(const Stars& stars, const Rect& bounds, float cellSize) {
+    const float width  = bounds.right - bounds.left;
+    const float height = bounds.top - bounds.bottom;
+
+    cellSize = std::max({ cellSize,
+                          width / static_cast<float>(kMaxCellsPerAxis),
+                          height / static_cast<float>(kMaxCellsPerAxis) });
+
+    bounds_      = bounds;
+    invCellSize_ = 1.0f / cellSize;
+    columns_     = std::clamp(static_cast<int>(std::ceil(width * invCellSize_)), 1, kMaxCellsPerAxis);
+    rows_        = std::clamp(static_cast<int>(std::ceil(height * invCellSize_)), 1, kMaxCellsPerAxis);
+
+    const std::size_t cells = static_cast<std::size_t>(columns_) * static_cast<std::size_t>(rows_);
+    const std::size_t count = stars.size();
+
+    cellStart_.assign(cells + 1U, 0U);
+    starIds_.resize(count);
+    starCell_.resize(count);
+
+    // count stars per cell, shifted by one so the prefix sum yields the starts
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto cell = static_cast<std::uint32_t>(cellRow(stars.y[i]) * columns_ + cellColumn(stars.x[i]));
+        starCell_[i] = cell;
+        ++cellStart_[cell + 1U];
+    }
+
+    for (std::size_t c = 0; c < cells; ++c) {
+        cellStart_[c + 1U] += cellStart_[c];
+    }
+
+    // scatter, using each cell's start as its write cursor and restoring it afterwards
+    for (std::size_t i = 0; i < count; ++i) {
+        starIds_[cellStart_[starCell_[i]]++] = static_cast<std::uint32_t>(i);
+    }
+
+    for (std::size_t c = cells; c > 0; --c) {
+        cellStart_[c] = cellStart_[c - 1U];
+    }
+    cellStart_[0] = 0U;
+}
+
+}  // namespace delaunay_flow
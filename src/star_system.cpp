@@ -1,52 +1,358 @@
 #include <star_system.hpp>
 
-#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
 
 
 namespace {
 
-[[nodiscard]] static float randomUniform(float start, float end) {
-    static thread_local std::mt19937 gen{ std::random_device{}() };
-    std::uniform_real_distribution<float> dist(start, end);
-    return dist(gen);
-}
+// stars per range of a parallel update; a multiple of the 8-wide motion kernel
+constexpr std::size_t kUpdateGrain = 1024;
+
+// steps run for one frame at most; a longer backlog is skipped in closed form so
+// a stall (debugger, suspend, a slow frame) can't snowball into ever longer frames
+constexpr std::uint64_t kMaxStepsPerFrame = 8;
+
+// the star grid is rebuilt once stars may have drifted this many cell sizes
+// from their cells; with the default star speeds that is every few dozen steps
+constexpr float kMaxGridSlack = 0.5f;
+
+// tiny sources would otherwise ask for an absurdly fine grid
+constexpr float kMinGridCellSize = 0.01f;
 
 } // namespace
 
 
 namespace delaunay_flow {
 
-StarSystem::StarSystem(const Settings& settings, Rect bounds)
-    : bounds_(bounds)
-    , settings_(settings)
+StarSystemParams starSystemParams(const Settings& settings) {
+    StarSystemParams params;
+    params.count               = settings.stars.count;
+    params.minSpeed            = settings.stars.minSpeed;
+    params.maxSpeed            = settings.stars.maxSpeed;
+    params.stepRate            = settings.simulation.rate;
+    params.seed                = settings.simulation.seed;
+    params.separation          = settings.simulation.separation;
+    params.separationStiffness = settings.simulation.separationStiffness;
+    params.motion              = settings.simulation.motion;
+    params.flowScale           = settings.simulation.flowScale;
+    params.flowRefresh         = settings.simulation.flowRefresh;
+    params.threads             = settings.simulation.threads > 0
+        ? static_cast<std::size_t>(settings.simulation.threads)
+        : std::max<std::size_t>(std::thread::hardware_concurrency(), 1U);
+    return params;
+}
+
+StarSystemParams starSystemParams(const TraceHeader& header, std::size_t threads) {
+    StarSystemParams params;
+    params.count               = static_cast<int>(header.count);
+    params.minSpeed            = header.minSpeed;
+    params.maxSpeed            = header.maxSpeed;
+    params.stepRate            = header.stepRate;
+    params.seed                = header.seed;
+    params.separation          = header.separation;
+    params.separationStiffness = header.separationStiffness;
+    params.motion              = header.motion;
+    params.flowScale           = header.flowScale;
+    params.flowRefresh         = header.flowRefresh;
+    params.threads             = threads;
+    return params;
+}
+
+TraceHeader traceHeader(const StarSystem& starSystem) {
+    const StarSystemParams& params = starSystem.params();
+
+    TraceHeader header;
+    header.seed                = starSystem.seed();
+    header.count               = static_cast<std::uint32_t>(params.count);
+    header.minSpeed            = params.minSpeed;
+    header.maxSpeed            = params.maxSpeed;
+    header.stepRate            = params.stepRate;
+    header.separation          = params.separation;
+    header.separationStiffness = params.separationStiffness;
+    header.motion              = params.motion;
+    header.flowScale           = params.flowScale;
+    header.flowRefresh         = params.flowRefresh;
+    header.bounds              = Rect(starSystem.left(), starSystem.right(), starSystem.bottom(), starSystem.top());
+    return header;
+}
+
+StarSystem::StarSystem(const StarSystemParams& params, Rect bounds)
+    : stepTime_(1.0f / params.stepRate)
+    , bounds_(bounds)
+    , params_(params)
+    , seed_(params.seed != 0 ? params.seed : std::random_device{}())
+    , gen_(seed_)
+    , pool_(params.threads > 1 ? std::make_unique<ThreadPool>(params.threads) : nullptr)
 {
     reset();
 }
 
+float StarSystem::randomUniform(float start, float end) {
+    std::uniform_real_distribution<float> dist(start, end);
+    return dist(gen_);
+}
+
 void StarSystem::reset() {
     stars_.clear();
-    stars_.reserve(static_cast<std::size_t>(settings_.stars.count));
+    stars_.reserve(static_cast<std::size_t>(params_.count));
 
-    for (int i = 0; i < settings_.stars.count; ++i) {
+    for (int i = 0; i < params_.count; ++i) {
         const float x     = randomUniform(bounds_.left, bounds_.right);
         const float y     = randomUniform(bounds_.bottom, bounds_.top);
 
-        const float speed = randomUniform(settings_.stars.minSpeed, settings_.stars.maxSpeed);
+        const float speed = randomUniform(params_.minSpeed, params_.maxSpeed);
         const float angle = randomUniform(0.0f, TAU_F);
         
-        stars_.emplace_back(x, y, speed, angle);
+        stars_.add(x, y, speed, angle);
+    }
+
+    // drawn after the stars, so the bounce layout for a seed doesn't depend on the mode
+    if (params_.motion == Motion::Flow) {
+        flow_.reset(bounds_, params_.flowScale, params_.flowRefresh, static_cast<std::uint32_t>(gen_()));
     }
+
+    prevX_ = stars_.x;
+    prevY_ = stars_.y;
+    drawX_ = stars_.x;
+    drawY_ = stars_.y;
+
+    accumulator_ = 0.0f;
+    alpha_       = 0.0f;
+    gridSlack_   = std::numeric_limits<float>::infinity();
+
+    // the old mesh doesn't describe the new stars
+    edges_.clear();
 }
 
-void StarSystem::update(std::chrono::duration<float> dt, float mouseXNDC, float mouseYNDC) {
-    const float dtSeconds = dt.count();
+delaunator::point_view<float> StarSystem::positions() const noexcept {
+    if (stars_.empty()) {
+        return {};
+    }
+    return { drawX_.data(), drawY_.data(), drawX_.size(), sizeof(float) };
+}
+
+void StarSystem::advance(std::chrono::duration<float> frameTime, std::span<const InteractionSource> sources) {
+    accumulator_ += std::max(frameTime.count(), 0.0f);
+
+    const auto backlog = static_cast<std::uint64_t>(accumulator_ / stepTime_);
+    if (backlog > kMaxStepsPerFrame) {
+        skipSteps(backlog - 1);
+        accumulator_ = std::fmod(accumulator_, stepTime_) + stepTime_;
+    }
+
+    while (accumulator_ >= stepTime_) {
+        step(sources);
+        accumulator_ -= stepTime_;
+    }
+
+    alpha_ = accumulator_ / stepTime_;
+    interpolate();
+}
+
+void StarSystem::fastForward(std::chrono::duration<double> time) {
+    const double backlog = accumulator_ + std::max(time.count(), 0.0);
+    const auto   steps   = static_cast<std::uint64_t>(backlog / stepTime_);
+
+    skipSteps(steps);
+    accumulator_ = static_cast<float>(backlog - static_cast<double>(steps) * stepTime_);
+
+    alpha_ = accumulator_ / stepTime_;
+    interpolate();
+}
+
+void StarSystem::skipSteps(std::uint64_t steps) {
+    if (steps == 0 || params_.motion == Motion::Flow) {
+        return;
+    }
+
+    const StarMotion motion{ stepTime_, bounds_ };
+    if (!pool_) {
+        fastForwardStars(stars_, motion, steps, 0, stars_.size());
+    } else {
+        pool_->parallelFor(stars_.size(), kUpdateGrain, [this, &motion, steps](std::size_t begin, std::size_t end) {
+            fastForwardStars(stars_, motion, steps, begin, end);
+        });
+    }
+
+    // nothing to blend from, and both the grid and the mesh are out of date
+    prevX_     = stars_.x;
+    prevY_     = stars_.y;
+    gridSlack_ = std::numeric_limits<float>::infinity();
+    edges_.clear();
+}
+
+void StarSystem::step(std::span<const InteractionSource> sources) {
+    prevX_ = stars_.x;
+    prevY_ = stars_.y;
+
+    const StarMotion motion{ stepTime_, bounds_ };
 
-    Star::mouseXNDC = mouseXNDC;
-    Star::mouseYNDC = mouseYNDC;
-    Star::mouseKeepDistance = settings_.interaction.distanceFromMouse;
+    const bool flowing = params_.motion == Motion::Flow;
+    if (flowing) {
+        flow_.advance(stepTime_);
+    }
+    const FlowTable flow = flowing ? flow_.table() : FlowTable{};
+
+    const auto move = [this, &motion, &flow, flowing](std::size_t begin, std::size_t end) {
+        return flowing ? moveStarsFlow(stars_, motion, flow, begin, end)
+                       : moveStars(stars_, motion, begin, end);
+    };
+
+    float moved = 0.0f;
+    if (!pool_) {
+        moved = move(0, stars_.size());
+    } else {
+        std::atomic<float> maxShift{0.0f};
+        pool_->parallelFor(stars_.size(), kUpdateGrain, [&move, &maxShift](std::size_t begin, std::size_t end) {
+            const float shift = move(begin, end);
+            float current = maxShift.load(std::memory_order_relaxed);
+            while (shift > current && !maxShift.compare_exchange_weak(current, shift, std::memory_order_relaxed)) {
+            }
+        });
+        moved = maxShift.load(std::memory_order_relaxed);
+    }
+
+    if (params_.separation > 0.0f && !edges_.empty()) {
+        moved += separate();
+    }
+
+    // no star is further than gridSlack_ from the cell it was binned into, so
+    // widening every query by that much still finds each star a source reaches
+    gridSlack_ += moved;
+
+    if (!sources.empty()) {
+        applySources(sources);
+    }
+}
+
+void StarSystem::applySources(std::span<const InteractionSource> sources) {
+    // cells as large as the smallest source: its query spans at most 4 x 4 of them
+    float cellSize = sources.front().radius;
+    for (const InteractionSource& source : sources) {
+        cellSize = std::min(cellSize, source.radius);
+    }
+    cellSize = std::max(cellSize, kMinGridCellSize);
+
+    if (gridSlack_ > cellSize * kMaxGridSlack || cellSize != gridCellSize_) {
+        grid_.rebuild(stars_, bounds_, cellSize);
+        gridCellSize_ = cellSize;
+        gridSlack_    = 0.0f;
+    }
+
+    // pair each source with the cells it reaches and sort by cell, so every star
+    // is loaded once and sees the sources in list order, however many there are.
+    // A star pushed into another source's reach by an earlier one joins it next step
+    sourceCells_.clear();
+    for (std::size_t s = 0; s < sources.size(); ++s) {
+        const InteractionSource& source = sources[s];
+        grid_.forEachCellNear(source.x, source.y, source.radius + gridSlack_, [this, s](std::uint32_t cell) {
+            sourceCells_.push_back(static_cast<std::uint64_t>(cell) << 32U | s);
+        });
+    }
+    std::sort(sourceCells_.begin(), sourceCells_.end());
+
+    float pushed = 0.0f;
+    for (std::size_t first = 0; first < sourceCells_.size();) {
+        const auto cell = static_cast<std::uint32_t>(sourceCells_[first] >> 32U);
+
+        std::size_t last = first + 1;
+        while (last < sourceCells_.size() && (sourceCells_[last] >> 32U) == cell) {
+            ++last;
+        }
+
+        for (const std::uint32_t i : grid_.cellStars(cell)) {
+            float shift = 0.0f;
+            for (std::size_t k = first; k < last; ++k) {
+                const auto s = static_cast<std::size_t>(sourceCells_[k] & 0xFFFFFFFFU);
+                shift += applySource(stars_, i, sources[s]);
+            }
+            pushed = std::max(pushed, shift);
+        }
+
+        first = last;
+    }
+    gridSlack_ += pushed;
+}
+
+void StarSystem::setNeighbors(std::span<const std::uint32_t> triangles, std::span<const std::uint32_t> halfedges) {
+    edges_.clear();
+    if (params_.separation <= 0.0f || triangles.empty() || halfedges.size() != triangles.size()) {
+        return;
+    }
+
+    edges_.reserve(triangles.size());
+    for (std::size_t e = 0; e < halfedges.size(); ++e) {
+        // interior edges appear twice, once per side; hull edges once
+        const std::uint32_t opposite = halfedges[e];
+        if (opposite == delaunator::Delaunator32::INVALID_INDEX || e < opposite) {
+            const std::size_t next = (e % 3U == 2U) ? e - 2U : e + 1U;
+            edges_.push_back(triangles[e]);
+            edges_.push_back(triangles[next]);
+        }
+    }
+}
+
+float StarSystem::separate() {
+    const std::size_t count         = stars_.size();
+    const float       minimum       = params_.separation;
+    const float       halfStiffness = 0.5f * params_.separationStiffness;
+
+    shiftX_.assign(count, 0.0f);
+    shiftY_.assign(count, 0.0f);
+
+    // every edge reads the positions from before this pass, so the result doesn't
+    // depend on the edge order; both ends give way by half the overlap
+    for (std::size_t k = 0; k < edges_.size(); k += 2U) {
+        const std::uint32_t a = edges_[k];
+        const std::uint32_t b = edges_[k + 1U];
+        if (a >= count || b >= count) {
+            continue;
+        }
+
+        const float dx   = stars_.x[b] - stars_.x[a];
+        const float dy   = stars_.y[b] - stars_.y[a];
+        const float dSqr = dx * dx + dy * dy;
+
+        if (dSqr == 0.0f || dSqr >= minimum * minimum) {
+            continue;
+        }
+
+        const float distance = std::sqrt(dSqr);
+        const float push     = halfStiffness * (minimum - distance) / distance;
+
+        shiftX_[a] -= dx * push;
+        shiftY_[a] -= dy * push;
+        shiftX_[b] += dx * push;
+        shiftY_[b] += dy * push;
+    }
+
+    // the origin moves along so the easing doesn't pull the pair back together
+    float maxShift = 0.0f;
+    for (std::size_t i = 0; i < count; ++i) {
+        const float sx = shiftX_[i];
+        const float sy = shiftY_[i];
+        if (sx == 0.0f && sy == 0.0f) {
+            continue;
+        }
+
+        stars_.x[i]    += sx;
+        stars_.y[i]    += sy;
+        stars_.orgx[i] += sx;
+        stars_.orgy[i] += sy;
+
+        maxShift = std::max({ maxShift, std::abs(sx), std::abs(sy) });
+    }
+    return maxShift;
+}
 
-    for (Star& star : stars_) {
-        star.move(dtSeconds, bounds_);
+void StarSystem::interpolate() {
+    const float alpha = alpha_;
+    for (std::size_t i = 0; i < drawX_.size(); ++i) {
+        drawX_[i] = prevX_[i] + (stars_.x[i] - prevX_[i]) * alpha;
+        drawY_[i] = prevY_[i] + (stars_.y[i] - prevY_[i]) * alpha;
     }
 }
 
@@ -0,0 +1,83 @@
+#include <thread_pool.hpp>
+
+#include <algorithm>
+
+namespace delaunay_flow {
+
+ThreadPool::ThreadPool(std::size_t threads) {
+    const std::size_t workers = std::max<std::size_t>(threads, 1U) - 1U;
+    workers_.reserve(workers);
+    for (std::size_t i = 0; i < workers; ++i) {
+        workers_.emplace_back([this, i] { workerLoop(i + 1U); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    // std::jthread joins on destruction
+}
+
+void ThreadPool::parallelFor(std::size_t count, std::size_t grain, const RangeFunc& func) {
+    grain = std::max<std::size_t>(grain, 1U);
+
+    // ranges of whole grains, spread over as many threads as have work
+    const std::size_t grains = (count + grain - 1U) / grain;
+    const std::size_t chunk  = (grains + size() - 1U) / size() * grain;
+
+    if (workers_.empty() || count <= chunk) {
+        func(0, count);
+        return;
+    }
+
+    {
+        std::lock_guard lock(mutex_);
+        func_    = &func;
+        count_   = count;
+        chunk_   = chunk;
+        pending_ = workers_.size();
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    runRange(0);
+
+    std::unique_lock lock(mutex_);
+    done_.wait(lock, [this] { return pending_ == 0; });
+    func_ = nullptr;
+}
+
+void ThreadPool::workerLoop(std::size_t index) {
+    std::size_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock lock(mutex_);
+            wake_.wait(lock, [this, seen] { return stop_ || generation_ != seen; });
+            if (stop_) {
+                return;
+            }
+            seen = generation_;
+        }
+
+        runRange(index);
+
+        // notify under the lock: once pending_ hits zero the caller may destroy the pool
+        std::lock_guard lock(mutex_);
+        if (--pending_ == 0) {
+            done_.notify_one();
+        }
+    }
+}
+
+void ThreadPool::runRange(std::size_t index) const {
+    const std::size_t begin = std::min(index * chunk_, count_);
+    const std::size_t end   = std::min(begin + chunk_, count_);
+    if (begin < end) {
+        (*func_)(begin, end);
+    }
+}
+
+}  // namespace delaunay_flow
@@ -0,0 +1,207 @@
+// delaunator_test: correctness checks for delaunator::Delaunator that the benchmark
+// doesn't make. Each case prints its name and whether it passed; the exit code is
+// the number of failed cases.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <delaunator/delaunator.hpp>
+
+namespace {
+
+// halfedges pair up and no triangle is inverted (orient()'s sign, in double)
+template <typename D, typename Scalar>
+bool isValidMesh(const D& d, const std::vector<Scalar>& coords) {
+    const auto next = [](std::size_t e) { return e % 3 == 2 ? e - 2 : e + 1; };
+
+    for (std::size_t a = 0; a < d.halfedges.size(); ++a) {
+        const auto b = d.halfedges[a];
+        if (b == D::INVALID_INDEX) continue;
+        if (d.halfedges[b] != a) return false;
+        if (d.triangles[a] != d.triangles[next(b)] || d.triangles[next(a)] != d.triangles[b]) return false;
+    }
+
+    for (std::size_t t = 0; t < d.triangles.size(); t += 3) {
+        const double px = coords[2 * d.triangles[t]];
+        const double py = coords[2 * d.triangles[t] + 1];
+        const double qx = coords[2 * d.triangles[t + 1]];
+        const double qy = coords[2 * d.triangles[t + 1] + 1];
+        const double rx = coords[2 * d.triangles[t + 2]];
+        const double ry = coords[2 * d.triangles[t + 2] + 1];
+        if ((qy - py) * (rx - qx) - (qx - px) * (ry - qy) < 0.0) return false;
+    }
+    return true;
+}
+
+int gFailed = 0;
+
+void report(std::string_view name, bool passed) {
+    std::cout << (passed ? "pass  " : "FAIL  ") << name << '\n';
+    if (!passed) ++gFailed;
+}
+
+// points along y = 0.3x with 1e-4 of jitter: slivers everywhere, and the seams of the
+// parallel build cross thousands of them. in_circle alone used to fold one there
+void nearCollinearParallel() {
+    constexpr std::size_t kPoints = 300'000;
+
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<float> x(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> jitter(-1e-4f, 1e-4f);
+
+    std::vector<float> coords(2 * kPoints);
+    for (std::size_t i = 0; i < kPoints; ++i) {
+        coords[2 * i]     = x(gen);
+        coords[2 * i + 1] = 0.3f * coords[2 * i] + jitter(gen);
+    }
+
+    delaunator::Delaunator32 serial;
+    serial.update(coords);
+    delaunator::Delaunator32 parallel;
+    parallel.update(coords, 8);
+
+    report("near-collinear 300k, serial", isValidMesh(serial, coords));
+    report("near-collinear 300k, 8 threads", isValidMesh(parallel, coords));
+    report("near-collinear 300k, same triangle count", serial.triangles.size() == parallel.triangles.size());
+}
+
+// a grid's strips share x coordinates, so the parallel build must hand it to the
+// serial sweep (before triangulating any strip) and still produce a valid mesh
+void gridParallel() {
+    constexpr int kSide = 548;
+
+    std::vector<double> coords;
+    coords.reserve(2 * kSide * kSide);
+    for (int i = 0; i < kSide; ++i) {
+        for (int j = 0; j < kSide; ++j) {
+            coords.push_back(i * 0.01);
+            coords.push_back(j * 0.01);
+        }
+    }
+
+    delaunator::Delaunator d;
+    d.update(coords, 8);
+    report("grid 300k, 8 threads", isValidMesh(d, coords));
+}
+
+// 100k points drifting 2e-5 per frame, bouncing off the unit square, about the
+// wallpaper's pace relative to the point spacing. repair() must leave a valid mesh
+// every frame and keep most frames instead of falling back to update()
+void kineticRepair() {
+    constexpr std::size_t kPoints = 100'000;
+    constexpr int kFrames = 60;
+    constexpr int kMinRepaired = 54;
+    constexpr float kStep = 2e-5f;
+
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<float> position(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+
+    std::vector<float> coords(2 * kPoints);
+    std::vector<float> velocity(2 * kPoints);
+    for (std::size_t i = 0; i < kPoints; ++i) {
+        coords[2 * i]       = position(gen);
+        coords[2 * i + 1]   = position(gen);
+        const float a       = angle(gen);
+        velocity[2 * i]     = kStep * std::cos(a);
+        velocity[2 * i + 1] = kStep * std::sin(a);
+    }
+
+    delaunator::Delaunator32 d;
+    d.update(coords);
+
+    int repaired = 0;
+    bool valid = true;
+    for (int f = 0; f < kFrames; ++f) {
+        for (std::size_t k = 0; k < coords.size(); ++k) {
+            coords[k] += velocity[k];
+            if (std::abs(coords[k]) > 1.0f) velocity[k] = -velocity[k];
+        }
+        if (d.repair(coords)) ++repaired;
+        valid = valid && isValidMesh(d, coords);
+    }
+
+    report("kinetic repair 100k, valid every frame", valid);
+    report("kinetic repair 100k, repaired " + std::to_string(repaired) + " of " + std::to_string(kFrames) + " frames",
+           repaired >= kMinRepaired);
+}
+
+// every simd_level has to build and repair exactly the mesh the scalar predicates do,
+// both through interleaved float coordinates and through a strided double view
+template <typename D, typename Scalar>
+std::vector<typename D::index_type> meshSnapshot(delaunator::point_view<Scalar> view, std::vector<Scalar>& moving) {
+    std::vector<typename D::index_type> snapshot;
+    D d;
+    d.update(view);
+    snapshot.insert(snapshot.end(), d.triangles.begin(), d.triangles.end());
+    snapshot.insert(snapshot.end(), d.halfedges.begin(), d.halfedges.end());
+
+    // a few frames of drift so repair() runs its batched Delaunay pass
+    for (int f = 0; f < 8; ++f) {
+        for (std::size_t k = 0; k < moving.size(); ++k) {
+            moving[k] += static_cast<Scalar>((k % 7 == 0 ? 3e-4 : -1e-4) * (f % 2 == 0 ? 1 : -1));
+        }
+        d.repair(view);
+        snapshot.insert(snapshot.end(), d.triangles.begin(), d.triangles.end());
+    }
+    return snapshot;
+}
+
+void simdLevels() {
+    constexpr std::size_t kPoints = 50'000;
+    const delaunator::simd_level supported = delaunator::get_simd_level();
+
+    std::mt19937 gen(5);
+    std::uniform_real_distribution<double> position(-1.0, 1.0);
+    std::vector<float> coords(2 * kPoints);
+    std::vector<double> strided(3 * kPoints); // x, y and an unused third field
+    for (std::size_t i = 0; i < kPoints; ++i) {
+        coords[2 * i]      = static_cast<float>(position(gen));
+        coords[2 * i + 1]  = static_cast<float>(position(gen));
+        strided[3 * i]     = position(gen);
+        strided[3 * i + 1] = position(gen);
+    }
+
+    const auto run = [&](delaunator::simd_level level) {
+        delaunator::set_simd_level(level);
+        std::vector<float> floats = coords;
+        std::vector<double> doubles = strided;
+        return std::make_pair(
+            meshSnapshot<delaunator::Delaunator32>(delaunator::point_view<float>(floats), floats),
+            meshSnapshot<delaunator::Delaunator>(
+                delaunator::point_view<double>(doubles.data(), doubles.data() + 1, kPoints, 3 * sizeof(double)),
+                doubles));
+    };
+
+    const auto scalar = run(delaunator::simd_level::scalar);
+    const std::pair<delaunator::simd_level, std::string_view> levels[] = {
+        {delaunator::simd_level::sse2, "sse2"},
+        {delaunator::simd_level::avx2, "avx2"},
+        {delaunator::simd_level::avx512, "avx512"},
+    };
+    for (const auto& [level, name] : levels) {
+        if (level > supported) break;
+        const auto result = run(level);
+        report(std::string("simd ") + std::string(name) + ", float mesh matches scalar", result.first == scalar.first);
+        report(std::string("simd ") + std::string(name) + ", strided double mesh matches scalar",
+               result.second == scalar.second);
+    }
+    delaunator::set_simd_level(supported);
+}
+
+} // namespace
+
+int main() {
+    nearCollinearParallel();
+    gridParallel();
+    kineticRepair();
+    simdLevels();
+    return gFailed;
+}